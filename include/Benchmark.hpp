@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Util.hpp"
+#include "Print.hpp"
+#include <chrono>
+#ifdef MY_MCU_HEADER //target build
+#include "System.hpp"
+#include "Systick.hpp"
+#include "Lptim.hpp"
+#endif
+
+
+//........................................................................................
+
+                // time a function a number of times and print a table row of the
+                // min/avg/max cost (the fixed cost of taking a measurement is removed)
+
+                // target- cpu cycles from the SysTick down counter (CVR), each run is
+                //  done with irq's off so an irq cannot land in the measurement, a run
+                //  has to be less than 1 SysTick reload period (so less than the Systick
+                //  irq period, or 2^24 cycles if Systick is not in use)
+                // host (no MY_MCU_HEADER)- nanoseconds from steady_clock, irq's and
+                //  scheduling will show up in the max (use min)
+
+                //  Benchmark bench{ uart };
+                //  bench.header( "clocks" );
+                //  bench.run( "Systick::now()", []{ return Systick::now(); } );
+                //  bench.run( "time_point <<", [&]{ sink << Systick::now(); } );
+
+////////////////
+class
+Benchmark
+////////////////
+                {
+
+                #ifdef MY_MCU_HEADER
+                //SysTick registers (same as Systick class)
+                struct Reg { u32 CSR, RVR, CVR; const u32 CALIB; };
+                static inline volatile Reg& reg_{ *(reinterpret_cast<Reg*>(0xE000'E010)) };
+
+                static constexpr auto UNITS_{ "cycles" };
+                #else
+                static constexpr auto UNITS_{ "ns" };
+                #endif
+
+                FMT::Print& out_;
+                u32         runs_;
+                u32         overhead_{ 0 }; //cost of an empty measurement
+
+                //one measurement of f (the result of f is kept so f is not optimized away)
+                template<typename F> static u32
+sample          (F f)
+                {
+                #ifdef MY_MCU_HEADER
+                InterruptLock lock;
+                u32 t0 = reg_.CVR;
+                if constexpr( std::is_void_v<decltype(f())> ) f();
+                else { auto r = f(); asm volatile( "" : : "g"(&r) : "memory" ); }
+                u32 t1 = reg_.CVR;
+                //down counter, reloads from RVR (at most 1 reload in a run)
+                return t0 >= t1 ? t0 - t1 : t0 + reg_.RVR + 1 - t1;
+                #else
+                auto t0 = std::chrono::steady_clock::now();
+                if constexpr( std::is_void_v<decltype(f())> ) f();
+                else { auto r = f(); asm volatile( "" : : "g"(&r) : "memory" ); }
+                auto t1 = std::chrono::steady_clock::now();
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+                #endif
+                }
+
+                //min of the empty measurement is the overhead
+                void
+calibrate       ()
+                {
+                overhead_ = 0xFFFFFFFF;
+                for( u32 i = 0; i < runs_; i++ ){
+                    auto v = sample( []{} );
+                    if( v < overhead_ ) overhead_ = v;
+                    }
+                }
+
+public:
+
+Benchmark       (FMT::Print& out, u32 runs = 100)
+                : out_(out), runs_(runs ? runs : 1)
+                {
+                #ifdef MY_MCU_HEADER
+                //SysTick not running (Systick class not in use), run it without the irq
+                if( (reg_.CSR bitand 1) == 0 ){ reg_.RVR = 0xFFFFFF; reg_.CVR = 0; reg_.CSR = 5; }
+                #endif
+                calibrate();
+                }
+
+                Benchmark&
+header          (const char* title)
+                {
+                out_ << FMT::endl << title << " (" << UNITS_ << ", " << FMT::dec << runs_
+                     << " runs, overhead " << overhead_ << " removed)" << FMT::endl
+                     << FMT::setwf(28,' ') << FMT::left << "" << FMT::right
+                     << FMT::setw(10) << "min" << FMT::setw(10) << "avg" << FMT::setw(10) << "max"
+                     << FMT::endl;
+                return *this;
+                }
+
+                //run f runs_ times, print a table row
+                template<typename F> Benchmark&
+run             (const char* name, F f)
+                {
+                u32 mn = 0xFFFFFFFF, mx = 0;
+                u64 sum = 0;
+                for( u32 i = 0; i < runs_; i++ ){
+                    auto v = sample( f );
+                    v = v > overhead_ ? v - overhead_ : 0;
+                    if( v < mn ) mn = v;
+                    if( v > mx ) mx = v;
+                    sum += v;
+                    }
+                out_ << FMT::setwf(28,' ') << FMT::left << name << FMT::dec_(10,mn)
+                     << FMT::dec_(10,static_cast<u32>(sum/runs_)) << FMT::dec_(10,mx) << FMT::endl;
+                return *this;
+                }
+
+                }; //Benchmark
+
+//........................................................................................
+
+                //Print that discards its output (so a formatting benchmark does not also
+                //time the device being printed to)
+////////////////
+class
+PrintDiscard    : public FMT::Print
+////////////////
+                {
+                bool
+write           (const char) override { return true; }
+                u32
+write           (const char*, u32 n) override { return n; }
+                };
+
+//........................................................................................
+
+                #ifdef MY_MCU_HEADER
+
+                //the clock paths on target- now(), and the private cycle counting and
+                //conversion functions (Systick and Lptim1ClockLSI have this as a friend)
+                //the Systick clock is started if not already in use (and stays running, so
+                //if Lptim1ClockLSI is the system clock the cpu is also woken by SysTick)
+////////////////
+struct
+ClockBench
+////////////////
+                {
+
+                static void
+run             (FMT::Print& out, u32 runs = 100)
+                {
+                Systick::now(); //start if not already running (a no-op if it is)
+                Benchmark bench{ out, runs };
+                PrintDiscard sink;
+                auto tp = Lptim1ClockLSI::now();
+                bench.header( "clocks" )
+                     .run( "Systick::now()", []{ return Systick::now(); } )
+                     .run( "Systick::cpuCycles()", []{ return Systick::cpuCycles(); } )
+                     .run( "Systick::cycles2chrono()", []{ return Systick::cycles2chrono(); } )
+                     .run( "Lptim::now()", []{ return Lptim1ClockLSI::now(); } )
+                     .run( "Lptim::lsiCycles()", []{ return Lptim1ClockLSI::lsiCycles(); } )
+                     .run( "Lptim::cycles2chrono()", []{ return Lptim1ClockLSI::cycles2chrono(); } )
+                     .run( "time_point << (format only)", [&]{ sink << tp; } )
+                     .run( "time_point << now()", [&]{ sink << Lptim1ClockLSI::now(); } );
+                }
+
+                }; //ClockBench
+
+                #endif
+
+//........................................................................................
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "Util.hpp"
+#include "Print.hpp"
+#include "Format.hpp"
+#include "BufferBytes.hpp"
+#include <array>
+#include <chrono>
+#include <type_traits>
+#include MY_MCU_HEADER
+
+
+//........................................................................................
+
+                // deferred binary logging- a log call only stores a small record (a string
+                // id and the raw argument bytes) into a ring buffer, the text is created on
+                // the pc by tools/logdecode.cpp from the elf file (format strings are not
+                // in the flash image)
+
+                // each format string is placed in the .logstr linker section (INFO, so is
+                // only in the elf), its address in that section is the id, the string is
+                // stored as- arg types (struct module style codes) '\0' format '\0'
+                // the format uses the FMT::format field syntax, and is checked at compile
+                // time the same way (field count must match the argument count)
+
+                //  static std::array<u8,512> logBuffer;
+                //  static BinLog binlog{ logBuffer };
+                //  BINLOG( binlog, "{} run count: {:5} [{:#06x}]\n", now(), n, n );
+                //  binlog.drain( uart ); //from a task, records -> uart (or any Print)
+
+                // record- A5 len idlo idhi args... sum  (len = id+args bytes, sum = 8bit
+                // sum of id+args) so the decoder can find records in a stream that also
+                // has normal text output (which passes through)
+
+                // argument types- integers, bool, char, float/double, std::chrono
+                // time_point/duration (as i64 us), const char* (address of a string in
+                // flash, the decoder reads it from the elf- do not use a ram string)
+
+                // BINLOG has to be used in a non-template, non-inline function (like the
+                // tasks in main.cpp)- gcc ignores the section attribute of a static in a
+                // template, and an inline function static is a comdat section which
+                // conflicts with the others
+
+                #define BINLOG(log, fmt, ...)                                                   \
+                    (log).write<fmt>( []{                                                       \
+                        [[gnu::section(".logstr"), gnu::used]] static constexpr auto str{       \
+                            BinLog::string<fmt>( decltype(BinLog::sigOf(__VA_ARGS__)){} ) };      \
+                        return reinterpret_cast<u32>(&str); }() __VA_OPT__(,) __VA_ARGS__ )
+
+////////////////
+class
+BinLog
+////////////////
+                {
+
+                enum { SYNC = 0xA5, ARGS_MAX = 250 };
+
+                BufferBytes     buffer_;
+                u32             dropped_{ 0 }; //records not written (buffer full)
+
+                //type code and size of an argument
+                template<typename T> static constexpr char
+code            ()
+                {
+                using namespace std::chrono;
+                if constexpr( std::is_same_v<T,bool> ) return '?';
+                else if constexpr( std::is_same_v<T,char> ) return 'c';
+                else if constexpr( std::is_integral_v<T> ){
+                    constexpr char codes[]{ "bBhHiIqQ" }; //size 1,2,4,8 signed/unsigned
+                    constexpr auto i = (sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 2 : sizeof(T) == 4 ? 4 : 6) + (std::is_unsigned_v<T> ? 1 : 0);
+                    return codes[i];
+                    }
+                else if constexpr( std::is_same_v<T,float> ) return 'f';
+                else if constexpr( std::is_same_v<T,double> ) return 'd';
+                else if constexpr( requires(T t){ duration_cast<microseconds>(t.time_since_epoch()); } ) return 'T';
+                else if constexpr( requires(T t){ duration_cast<microseconds>(t); } ) return 'D';
+                else if constexpr( std::is_convertible_v<T,const char*> ) return 's';
+                else { static_assert( sizeof(T) == 0, "BinLog: unsupported argument type" ); return 0; }
+                }
+
+                template<typename T> static constexpr u32
+size            ()
+                {
+                constexpr auto c = code<T>();
+                return c == 'b' or c == 'B' or c == '?' or c == 'c' ? 1 : c == 'h' or c == 'H' ? 2 :
+                       c == 'q' or c == 'Q' or c == 'd' or c == 'T' or c == 'D' ? 8 : 4;
+                }
+
+                //argument -> record bytes (little endian, same as the pc)
+                template<typename T> static void
+put             (u8*& p, const T& v)
+                {
+                using namespace std::chrono;
+                constexpr auto c = code<T>();
+                if constexpr( c == 'T' ){ i64 us = duration_cast<microseconds>(v.time_since_epoch()).count(); put( p, us ); }
+                else if constexpr( c == 'D' ){ i64 us = duration_cast<microseconds>(v).count(); put( p, us ); }
+                else if constexpr( c == 's' ){ u32 a = reinterpret_cast<u32>(static_cast<const char*>(v)); put( p, a ); }
+                else { __builtin_memcpy( p, &v, sizeof v ); p += sizeof v; }
+                }
+
+public:
+
+                //types of the arguments, for BINLOG (decltype only, not called)
+                template<typename... Ts> struct Sig {};
+                template<typename... Ts> static constexpr Sig<std::decay_t<Ts>...>*
+sigOf           (const Ts&...){ return nullptr; }
+
+                //the .logstr string- arg codes '\0' format '\0'
+                template<unsigned N> struct String { char s[N]; };
+                template<FMT::FixedString F, typename... Ts> static constexpr auto
+string          (Sig<Ts...>*)
+                {
+                constexpr unsigned NF = sizeof(F.s);
+                String<sizeof...(Ts) + 1 + NF> r{};
+                unsigned i = 0;
+                ( (r.s[i++] = code<Ts>()), ... );
+                r.s[i++] = 0;
+                for( auto c : F.s ) r.s[i++] = c;
+                return r;
+                }
+
+                template<unsigned N>
+BinLog          (std::array<u8,N>& buf)
+                : buffer_( buf )
+                {
+                }
+
+                //write a record (use BINLOG, which creates the id), false if no room
+                //(the record is dropped whole, never partially written)
+                template<FMT::FixedString F, typename... Ts> bool
+write           (u32 id, const Ts&... args)
+                {
+                constexpr auto& r = FMT::FormatOf<F>::v;
+                static_assert( r.err == FMT::FORMAT_OK, "BinLog: bad format string (see Format.hpp)" );
+                static_assert( r.count == sizeof...(Ts), "BinLog: number of {} fields and arguments do not match" );
+                constexpr u32 n = (0 + ... + size<std::decay_t<Ts>>());
+                static_assert( n <= ARGS_MAX, "BinLog: too many argument bytes" );
+                u8 rec[n + 5];
+                auto p = &rec[4];
+                ( put( p, args ), ... );
+                (void)p; //unused if no args
+                rec[0] = SYNC; rec[1] = n + 2; rec[2] = id; rec[3] = id >> 8;
+                u8 sum = 0;
+                for( u32 i = 2; i < n + 4; i++ ) sum += rec[i];
+                rec[n + 4] = sum;
+                InterruptLock lock;
+                if( buffer_.sizeFree() < sizeof rec ){ dropped_++; return false; }
+                buffer_.write( rec, sizeof rec );
+                return true;
+                }
+
+                //records -> Print device (a span at a time, straight from the buffer
+                //memory), returns bytes written
+                u32
+drain           (FMT::Print& p)
+                {
+                u32 count = 0;
+                while( true ){
+                    u32 n;
+                    auto s = buffer_.peek( n );
+                    if( n == 0 ) return count;
+                    p << std::string_view{ reinterpret_cast<const char*>(s), n };
+                    buffer_.consume( n );
+                    count += n;
+                    }
+                }
+
+                auto
+dropped         (){ return dropped_; }
+                auto
+bufferUsedMax   (){ return buffer_.sizeUsedMax(); }
+                auto
+isEmpty         (){ return buffer_.isEmpty(); }
+
+                }; //BinLog
+
+//........................................................................................
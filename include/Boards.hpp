@@ -8,6 +8,7 @@
 #include <array>
 #include "BufferBytes.hpp"
 #include "Ownership.hpp"
+#include "UartMux.hpp"
 
 
 //........................................................................................
@@ -28,10 +29,20 @@ Nucleo32g031
 
 private:        //not directly accessible
 
-                //uart buffer
+                //uart buffers
                 std::array<u8,256> uartBuffer_;
-                //Uart2, TX=PA2,RX=PA3 
-                Uart uart_{ MCU::Uart2_A2A3, 1'000'000, uartBuffer_, Nvic::PRIORITY2 };
+                std::array<u8,64> uartRxBuffer_;
+                //Uart2, TX=PA2,RX=PA3, tx via dma (1 irq per buffer run instead of per byte),
+                //rx via circular dma (irq's at line idle and each half buffer)
+                //(DMA1_CH2/CH3 share an irq, so CH3 is left for this uart also)
+                Uart uart_{ MCU::Uart2_A2A3, 1'000'000, uartBuffer_, uartRxBuffer_, Nvic::PRIORITY2,
+                            MCU::DMA1_CH1, MCU::DMA1_CH2 };
+
+                //uart tx events- tx complete goes to the Ownership (device idle, so a
+                //waiter gets its turn), and all wanted events to an optional user callback
+                static inline Uart::txEvent_t uartTxEventUser_{ nullptr };
+                static inline u8 uartTxEventsUser_{ 0 };
+                static void uartTxEvent(Uart::TX_EVENT e); //(after board declared, below)
 
                 //the uart is available for a new owner when the uart goes idle (buffer
                 //empty and tx complete), so a task can fill the buffer quickly and return
@@ -50,10 +61,52 @@ private:        //not directly accessible
 
 public:
 
+Nucleo32g031    (){ uart_.onTxEvent( uartTxEvent, Uart::TX_COMPLETE ); }
+
                 //fixed green led- LD3 (no Ownership)
                 Led led{ MCU::PC6 };
 
-                Ownership<Uart> uart{ uart_ };
+                Ownership<Uart> uart{ uart_, true }; //true = uart calls deviceIdle (tx complete)
+
+                //message granular uart sharing, no owner needed (see UartMux)
+                //      std::array<char,128> buf;
+                //      PrintBuffer msg{ buf };
+                //      msg << "Hello World" << endl;
+                //      if( not board.uartMux.send(msg) ) return false; //no room yet
+                UartMux uartMux{ uart, uart_ };
+
+                //uart rx does not need an owner (Ownership is for the tx side), so
+                //received bytes can be read at any time
+                bool
+uartRead        (u8& c){ return uart_.read(c); }
+                //received bytes in place (zero copy), see Uart::readSpan
+                const u8*
+uartReadSpan    (u32& n){ return uart_.readSpan(n); }
+                void
+uartReadDone    (u32 n){ uart_.readDone(n); }
+                //rx line went idle since the last call (a burst was received)
+                bool
+uartRxEvent     (){ return uart_.rxEvent(); }
+
+                //uart tx overflow policy and its drop counters (see Uart::overflowPolicy)
+                void
+uartOverflowPolicy(Uart::OVERFLOW_POLICY p){ uart_.overflowPolicy(p); }
+                Uart::OVERFLOW_POLICY
+uartOverflowPolicy(){ return uart_.overflowPolicy(); }
+                u32
+uartDroppedBytes(){ return uart_.droppedBytes(); }
+                u32
+uartDroppedMsgs (){ return uart_.droppedMsgs(); }
+
+                //uart tx events for a producer (from the uart isr, see Uart::onTxEvent),
+                //like refill at low water instead of polling for room
+                void
+uartOnTxEvent   (Uart::txEvent_t f, u8 events, u32 lowWater = 0)
+                {
+                uartTxEventUser_ = f;
+                uartTxEventsUser_ = f ? events : 0;
+                uart_.onTxEvent( uartTxEvent, events bitor Uart::TX_COMPLETE, lowWater );
+                }
 
                 //board pin labels to actual pins
                 static constexpr MCU::PIN D[]{ //0-12
@@ -89,4 +142,12 @@ public:
                 //instace of Board created (in some source file)
                 extern Board board;
 
+                inline void
+                Boards::Nucleo32g031::
+uartTxEvent     (Uart::TX_EVENT e)
+                {
+                if( e == Uart::TX_COMPLETE ) board.uart.deviceIdle();
+                if( uartTxEventsUser_ bitand e ) uartTxEventUser_( e );
+                }
+
 //........................................................................................
\ No newline at end of file
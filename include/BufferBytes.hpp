@@ -40,6 +40,13 @@ BufferBytes     (std::array<u8,N>& buf)
                 {
                 }
 
+                //no buffer (size 0, write always fails, read always empty)
+BufferBytes     () 
+                : buf_{ nullptr }, 
+                  size_{ 0 }
+                {
+                }
+
                 bool
 read            (u8& v)
                 {
@@ -61,6 +68,71 @@ write           (u8 v)
                 return true;
                 }
 
+                //bulk write, returns number of bytes written (up to the free space)
+                //(copied in at most 2 parts, count updated once)
+                u32
+write           (const u8* p, u32 n)
+                {
+                auto free = size_ - atom_count_;
+                if( n > free ) n = free;
+                if( n == 0 ) return 0;
+                auto n1 = size_ - wrIdx_; //room until end of buffer
+                if( n1 > n ) n1 = n;
+                __builtin_memcpy( &buf_[wrIdx_], p, n1 );
+                __builtin_memcpy( buf_, p + n1, n - n1 ); //wrapped part (if any)
+                wrIdx_ += n; 
+                if( wrIdx_ >= size_ ) wrIdx_ -= size_;
+                auto c = atom_count_ += n;
+                if( c > maxCount_ ) maxCount_ = c;
+                return n;
+                }
+
+                //zero copy access to the buffer memory, so a dma, formatter or other bulk
+                //producer/consumer can work in place
+
+                //writer- the largest contiguous free span from the write position (up to
+                //the end of the buffer, the rest is in the next span), fill k <= n bytes
+                //then commit(k) makes them readable
+                //(reserve..commit is not atomic- a buffer with writers at more than 1 irq
+                // level needs an InterruptLock around the pair, as write does for its count)
+                u8*
+reserve         (u32& n)
+                {
+                n = size_ - atom_count_;
+                auto n1 = size_ - wrIdx_;
+                if( n > n1 ) n = n1;
+                return &buf_[wrIdx_];
+                }
+
+                void
+commit          (u32 k)
+                {
+                wrIdx_ += k;
+                if( wrIdx_ >= size_ ) wrIdx_ -= size_;
+                auto c = atom_count_ += k;
+                if( c > maxCount_ ) maxCount_ = c;
+                }
+
+                //reader- contiguous bytes available from the read position (up to the
+                //end of the buffer, the rest is in the next span), read k <= n bytes in
+                //place then consume(k) frees them
+                const u8*
+peek            (u32& n)
+                {
+                n = atom_count_;
+                auto n1 = size_ - rdIdx_;
+                if( n > n1 ) n = n1;
+                return &buf_[rdIdx_];
+                }
+
+                void
+consume         (u32 k)
+                {
+                rdIdx_ += k;
+                if( rdIdx_ >= size_ ) rdIdx_ -= size_;
+                atom_count_ -= k;
+                }
+
                 auto
 clear           () 
                 {
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "Util.hpp"
+#include <array>
+
+
+//........................................................................................
+
+                // single producer/single consumer version of BufferBytes (one side can be
+                // an isr, like a task writing and a uart isr reading)
+
+                // the write index is only written by the producer and the read index only
+                // by the consumer, both free running (used = wr - rd, a u32 wrap is ok),
+                // and the buffer size is a power of 2 so the buffer index is a mask- there
+                // is no shared count, so no InterruptLock is needed between the 2 sides
+                // (a u32 load/store is atomic on the M0+, compiler barriers keep the
+                // buffer access after the load of the other side's index, and before
+                // the index update that hands it to the other side)
+
+                // clear() is the exception- both sides have to be stopped
+
+                // std::array<u8,128> buf; //size a power of 2
+                // BufferBytesSpsc mybuffer{ buf };
+
+////////////////
+class
+BufferBytesSpsc
+////////////////
+                {
+
+                u8* const           buf_;
+                u32 const           size_;
+                u32 const           mask_;
+
+                volatile u32        wrIdx_{0};      //producer only
+                volatile u32        rdIdx_{0};      //consumer only
+                u32                 maxCount_{0};   //producer only
+
+                static void
+barrier         (){ asm volatile( "" : : : "memory" ); }
+
+                void
+updateMax       (u32 wr)
+                {
+                auto c = wr - rdIdx_;
+                if( c > maxCount_ ) maxCount_ = c;
+                }
+
+public:
+
+                template<unsigned N>
+BufferBytesSpsc (std::array<u8,N>& buf)
+                : buf_{ buf.data() },
+                  size_{ N },
+                  mask_{ N-1 }
+                {
+                static_assert( N and (N bitand (N-1)) == 0, "BufferBytesSpsc size must be a power of 2" );
+                }
+
+                //no buffer (size 0, write always fails, read always empty)
+BufferBytesSpsc ()
+                : buf_{ nullptr },
+                  size_{ 0 },
+                  mask_{ 0 }
+                {
+                }
+
+                //consumer
+
+                bool
+read            (u8& v)
+                {
+                u32 rd = rdIdx_;
+                if( wrIdx_ == rd ) return false;
+                barrier();
+                v = buf_[rd bitand mask_];
+                barrier();
+                rdIdx_ = rd + 1;
+                return true;
+                }
+
+                //bulk read, returns number of bytes read (up to the bytes available)
+                u32
+read            (u8* p, u32 n)
+                {
+                u32 rd = rdIdx_;
+                auto used = wrIdx_ - rd;
+                barrier();
+                if( n > used ) n = used;
+                auto i = rd bitand mask_;
+                auto n1 = size_ - i; //bytes until end of buffer
+                if( n1 > n ) n1 = n;
+                __builtin_memcpy( p, &buf_[i], n1 );
+                __builtin_memcpy( p + n1, buf_, n - n1 ); //wrapped part (if any)
+                barrier();
+                rdIdx_ = rd + n;
+                return n;
+                }
+
+                //contiguous bytes available from the read position (read in place),
+                //consume(k) then frees them (see BufferBytes)
+                const u8*
+peek            (u32& n)
+                {
+                u32 rd = rdIdx_;
+                auto i = rd bitand mask_;
+                n = wrIdx_ - rd;
+                barrier();
+                if( n > size_ - i ) n = size_ - i;
+                return &buf_[i];
+                }
+
+                void
+consume         (u32 k)
+                {
+                barrier();
+                rdIdx_ = rdIdx_ + k;
+                }
+
+                //producer
+
+                bool
+write           (u8 v)
+                {
+                u32 wr = wrIdx_;
+                if( wr - rdIdx_ >= size_ ) return false;
+                barrier();
+                buf_[wr bitand mask_] = v;
+                barrier();
+                wrIdx_ = wr + 1;
+                updateMax( wr + 1 );
+                return true;
+                }
+
+                //bulk write, returns number of bytes written (up to the free space)
+                u32
+write           (const u8* p, u32 n)
+                {
+                u32 wr = wrIdx_;
+                auto free = size_ - (wr - rdIdx_);
+                barrier();
+                if( n > free ) n = free;
+                if( n == 0 ) return 0;
+                auto i = wr bitand mask_;
+                auto n1 = size_ - i; //room until end of buffer
+                if( n1 > n ) n1 = n;
+                __builtin_memcpy( &buf_[i], p, n1 );
+                __builtin_memcpy( buf_, p + n1, n - n1 ); //wrapped part (if any)
+                barrier();
+                wrIdx_ = wr + n;
+                updateMax( wr + n );
+                return n;
+                }
+
+                //largest contiguous free span from the write position (written in
+                //place), commit(k) then makes them readable
+                u8*
+reserve         (u32& n)
+                {
+                u32 wr = wrIdx_;
+                auto i = wr bitand mask_;
+                n = size_ - (wr - rdIdx_);
+                barrier();
+                if( n > size_ - i ) n = size_ - i;
+                return &buf_[i];
+                }
+
+                void
+commit          (u32 k)
+                {
+                barrier();
+                u32 wr = wrIdx_ + k;
+                wrIdx_ = wr;
+                updateMax( wr );
+                }
+
+                //remove the k newest bytes (up to all unread), returns bytes removed-
+                //the consumer has to be stopped (or irq's off if it is an isr), and not
+                //reading them in place (a peek span, like a tx dma run)
+                u32
+unwrite         (u32 k)
+                {
+                u32 wr = wrIdx_;
+                auto used = wr - rdIdx_;
+                if( k > used ) k = used;
+                wrIdx_ = wr - k;
+                return k;
+                }
+
+                //both sides stopped (or irq's off if one side is an isr)
+                auto
+clear           ()
+                {
+                wrIdx_ = 0;
+                rdIdx_ = 0;
+                maxCount_ = 0;
+                }
+
+                auto
+sizeUsedMax     () { return maxCount_; }
+                u32
+sizeUsed        () { return wrIdx_ - rdIdx_; }
+                auto
+size            () { return size_; }
+                auto
+sizeFree        () { return size_ - sizeUsed(); }
+                auto
+isFull          () { return sizeUsed() >= size_; }
+                auto
+isEmpty         () { return sizeUsed() == 0; }
+
+                }; //BufferBytesSpsc
+
+//........................................................................................
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Util.hpp"
+#include "Startup.hpp" //debugram
+#include MY_MCU_HEADER
+
+
+//........................................................................................
+
+                // a software reset (Scb::swReset from checkRstPin or errorFunc) restarts
+                // the chrono clocks at 0, so timestamps would jump backwards- the clocks
+                // checkpoint their time into debugram (which survives any reset but a 
+                // power on) and resume from the checkpoint after a reset
+
+                // a checkpoint is the highest time the clock can reach before its next
+                // checkpoint, so the resumed time is always >= any time seen before the 
+                // reset (monotonic), the time between the reset and the checkpoint is
+                // lost- the resume time is available from the clock (epoch()) so the
+                // discontinuity can be seen in the output (also see debugram.RESET_COUNT)
+
+                // checkpoint only moves forward, so more than one clock can checkpoint 
+                // (resumed time is then >= the times of all clocks)
+
+                // EPOCH[0] = low 32bits (us), EPOCH[1] = high 32bits, EPOCH[2] = check value
+                // (if reset happens between writes, check will fail and clocks start at 0)
+
+////////////////
+class
+ClockEpoch
+////////////////
+                {
+
+                static constexpr u32 CHECK_KEY_{ 0x5EC0'4D5A };
+
+                static auto&
+epoch           (){ return debugram.EPOCH; }
+
+                static i64
+read            ()
+                {
+                auto& e = epoch();
+                if( e[2] != (e[0] xor e[1] xor CHECK_KEY_) ) return 0; //power on, or bad checkpoint
+                return static_cast<i64>( (static_cast<u64>(e[1])<<32) bitor e[0] );
+                }
+
+public:
+
+                //time (us) to resume from, 0 if power on or no valid checkpoint
+                //(read once by the clocks at startup, before any checkpoint is written)
+                static i64
+resume          (){ return read(); }
+
+                //save time (us), only if later than what is already saved
+                static void
+checkpoint      (i64 us)
+                {
+                InterruptLock lock;
+                if( us <= read() ) return;
+                auto& e = epoch();
+                e[2] = 0; //invalid while writing
+                e[0] = static_cast<u32>(us);
+                e[1] = static_cast<u32>(static_cast<u64>(us)>>32);
+                e[2] = e[0] xor e[1] xor CHECK_KEY_;
+                }
+
+                }; //ClockEpoch
+
+//........................................................................................
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "Util.hpp"
+#include "Print.hpp"
+#include <chrono>
+
+
+//........................................................................................
+
+                // lightweight time sync to a host clock over a uart (ptp-lite), so device
+                // times can be correlated with host times without post processing
+
+                // exchange (ascii lines, every number is 16 hex digits- an i64 in us)
+                //  host   -> device  T<t1>             t1 = host time T sent
+                //  device -> host    R<t1><t2><t3>     t2 = device time T seen, t3 = device time R sent
+                //  host   -> device  D<t4>             t4 = host time R received
+                //  device -> host    A<offset><delay><ppb>  result (for host info)
+
+                // offset = ((t1-t2)+(t4-t3))/2 (host - device), delay = (t4-t1)-(t3-t2)
+                // a PI servo turns the offsets into a rate adjustment (skew) of the clock,
+                // a forward offset larger than STEP_MIN_ is stepped instead of slewed
+                // (the clock is monotonic, so it is never stepped back)
+
+                // the Clock needs now(), adjust(i32 ppb), adjust(), step(duration)
+                // (Lptim1ClockLSI, or a host stand-in)
+
+                // device times are taken when the line is seen and when the reply is
+                // written, so the rx/tx paths should not be backed up (poll often, reply
+                // when the uart is idle)- any asymmetry shows up as offset error
+
+                //  ClockSync<Lptim1ClockLSI> sync;
+                //  u8 c;
+                //  while( not sync.isReplyPending() and board.uartRead(c) ) sync.rx(c);
+                //  if( sync.isReplyPending() ) sync.reply( uart );
+
+////////////////
+template
+<typename Clock>
+class
+ClockSync
+////////////////
+                {
+
+                using duration = typename Clock::duration;
+
+                static constexpr i64 STEP_MIN_{ 1000 };         //us, step forward if more than this
+                static constexpr i64 PPB_MAX_{ 100'000'000 };   //10%, lsi is not very accurate
+                static constexpr i64 B_{ 1'000'000'000 };
+
+                enum { HEXN = 16, LINE_MAX = 1+HEXN };
+                enum STATE { IDLE, REPLY_R, REPLY_A };
+
+                char    line_[LINE_MAX];
+                int     lineIdx_{ 0 };
+                i64     lineAt_{ 0 };       //device time first char of line was seen
+                STATE   state_{ IDLE };
+                i64     t1_{0}, t2_{0}, t3_{0};
+                bool    haveT3_{ false };   //R was sent, waiting for D
+
+                //servo
+                bool    isSynced_{ false };
+                i64     lastAt_{ 0 };       //device time of last servo update
+                i64     freqPpb_{ 0 };      //integral term (skew estimate)
+                i64     offset_{ 0 };       //last offset, delay (for reply and info)
+                i64     delay_{ 0 };
+                u32     count_{ 0 };        //number of completed exchanges
+
+                static i64
+nowUs           (){ return Clock::now().time_since_epoch().count(); }
+
+                static i64
+clamp           (i64 v){ return v > PPB_MAX_ ? PPB_MAX_ : v < -PPB_MAX_ ? -PPB_MAX_ : v; }
+
+                //16 hex digits -> i64, false if not a hex digit
+                static bool
+hexToI64        (const char* str, i64& v)
+                {
+                u64 u = 0;
+                for( auto i = 0; i < HEXN; i++ ){
+                    auto c = str[i];
+                    u32 d = c >= '0' and c <= '9' ? c - '0' :
+                            c >= 'a' and c <= 'f' ? c - 'a' + 10 :
+                            c >= 'A' and c <= 'F' ? c - 'A' + 10 : 16;
+                    if( d > 15 ) return false;
+                    u = (u<<4) bitor d;
+                    }
+                v = static_cast<i64>(u);
+                return true;
+                }
+
+                //i64 -> 16 hex digits
+                static void
+printI64        (FMT::Print& p, i64 v){ p << FMT::hex0(16, static_cast<u64>(v)); }
+
+                void
+servo           (i64 offset, i64 delay)
+                {
+                offset_ = offset;
+                delay_ = delay;
+                count_++;
+                auto now = nowUs();
+                auto dt = now - lastAt_;
+                lastAt_ = now;
+                //first exchange or large forward offset, step (forward only)
+                if( not isSynced_ or offset > STEP_MIN_ ){
+                    if( offset > 0 ) Clock::step( duration(offset) );
+                    isSynced_ = true;
+                    return;
+                    }
+                if( dt <= 0 ) return;
+                //rate needed to remove the offset in one exchange interval
+                auto inst = clamp( offset * B_ / dt );
+                freqPpb_ = clamp( freqPpb_ + inst/8 );  //I, skew estimate
+                Clock::adjust( clamp(freqPpb_ + inst/2) ); //P, removes offset over a few intervals
+                }
+
+                void
+lineDone        ()
+                {
+                if( lineIdx_ != LINE_MAX ) return; //wrong length, ignore
+                i64 v;
+                if( not hexToI64(&line_[1], v) ) return;
+                if( line_[0] == 'T' ){
+                    t1_ = v;
+                    t2_ = lineAt_;
+                    haveT3_ = false;
+                    state_ = REPLY_R;
+                    }
+                else if( line_[0] == 'D' and haveT3_ ){
+                    haveT3_ = false;
+                    //offset = host - device
+                    servo( ((t1_ - t2_) + (v - t3_))/2, (v - t1_) - (t3_ - t2_) );
+                    state_ = REPLY_A;
+                    }
+                }
+
+public:
+
+                //feed a received char, returns true if a reply is pending
+                //(a new line is not processed until the reply is written)
+                bool
+rx              (char c)
+                {
+                if( state_ != IDLE ) return true;
+                if( c == '\r' ) return false;
+                if( c == '\n' ){
+                    lineDone();
+                    lineIdx_ = 0;
+                    return state_ != IDLE;
+                    }
+                if( lineIdx_ == 0 ) lineAt_ = nowUs();
+                if( lineIdx_ < LINE_MAX ) line_[lineIdx_] = c;
+                if( lineIdx_ <= LINE_MAX ) lineIdx_++; //LINE_MAX+1 = too long
+                return false;
+                }
+
+                bool
+isReplyPending  (){ return state_ != IDLE; }
+
+                //write any pending reply
+                void
+reply           (FMT::Print& p)
+                {
+                if( state_ == REPLY_R ){
+                    t3_ = nowUs();
+                    haveT3_ = true;
+                    p << 'R'; printI64(p, t1_); printI64(p, t2_); printI64(p, t3_); p << '\n' << FMT::dec;
+                    }
+                else if( state_ == REPLY_A ){
+                    p << 'A'; printI64(p, offset_); printI64(p, delay_); printI64(p, Clock::adjust()); p << '\n' << FMT::dec;
+                    }
+                state_ = IDLE;
+                }
+
+                //info
+                bool
+isSynced        (){ return isSynced_; }
+                i64
+offset          (){ return offset_; } //last offset, us (host - device)
+                i64
+delay           (){ return delay_; } //last round trip delay, us
+                i64
+skew            (){ return freqPpb_; } //skew estimate, ppb
+                u32
+count           (){ return count_; } //completed exchanges
+
+                }; //ClockSync
+
+//........................................................................................
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Util.hpp"
+#ifdef MY_MCU_HEADER //target build
+#include MY_MCU_HEADER
+#endif
+
+
+//........................................................................................
+
+                // crc-16/ccitt-false (poly 0x1021, init 0xFFFF, no reflection, no xor out)
+                // target- the CRC peripheral (16bit poly, bytes written to DR), with irq's
+                //  off so it can be used from any irq level
+                // host (no MY_MCU_HEADER)- computed in software, same result (the host
+                //  decoder checks the target frames with it)
+
+                //  u16 crc = Crc16::calc( buf, n );
+
+////////////////
+struct
+Crc16
+////////////////
+                {
+
+                static constexpr u16 POLY{ 0x1021 };
+                static constexpr u16 INIT{ 0xFFFF };
+
+                #ifdef MY_MCU_HEADER
+private:
+                struct Reg { u32 DR, IDR, CR, reserved_, INIT, POL; };
+                static inline volatile Reg& reg_{ *(reinterpret_cast<Reg*>(MCU::CRC_BASE)) };
+                enum { RESETbm = 1, POLYSIZE16bm = 1<<3 };
+public:
+
+                static u16
+calc            (const u8* p, u32 n)
+                {
+                InterruptLock lock;
+                MCU::RCCreg.AHBENR or_eq MCU::RCC_CRCENbm; //(no effect if already on)
+                reg_.POL = POLY;
+                reg_.INIT = INIT;
+                reg_.CR = POLYSIZE16bm bitor RESETbm; //reset loads INIT
+                auto& dr8 = *reinterpret_cast<volatile u8*>(&reg_.DR); //byte writes
+                for( u32 i = 0; i < n; i++ ) dr8 = p[i];
+                return reg_.DR;
+                }
+
+                #else
+
+                static u16
+calc            (const u8* p, u32 n)
+                {
+                u16 crc = INIT;
+                for( u32 i = 0; i < n; i++ ){
+                    crc ^= p[i] << 8;
+                    for( auto b = 0; b < 8; b++ ) crc = crc bitand 0x8000 ? (crc << 1) ^ POLY : crc << 1;
+                    }
+                return crc;
+                }
+
+                #endif
+
+                }; //Crc16
+
+//........................................................................................
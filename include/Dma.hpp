@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Util.hpp"
+#include MY_MCU_HEADER
+
+
+//........................................................................................
+
+                // a dma1 channel with its dmamux request- only the register access, the
+                // peripheral class using the channel handles the irq (it sets itself as
+                // the Isr for irqn(), and checks flags() in its isr)
+                // channels 2/3 and 4/5 share an irq, so a channel pair has to be used by
+                // the same peripheral class object (or only 1 of the pair used)
+
+                // 8bit transfers (peripheral and memory), priority low
+
+                //      DmaChannel dma{ MCU::DMA1_CH1, MCU::USART2_TX_REQ };
+                //      dma.start( &uartReg.TDR, buf, n, DmaChannel::MEM2PERIPH bitor DmaChannel::TCIE );
+                //      isr- if( dma.flags() bitand DmaChannel::TCIF ){ dma.clear(); ... }
+
+////////////////
+class
+DmaChannel
+////////////////
+                {
+
+                //ISR/IFCR are shared by all channels, but IFCR is write 1 to clear and
+                //ISR is read only, and a channel only touches its own CCR, so no atomic
+                //protection is needed
+                struct ChReg { u32 CCR, CNDTR, CPAR, CMAR, reserved_; };
+                struct Reg { u32 ISR, IFCR; ChReg CH[5]; };
+
+                static inline volatile Reg& reg_{ *(reinterpret_cast<Reg*>(MCU::DMA1_BASE)) };
+                static inline volatile u32* const dmamuxCCR_{ reinterpret_cast<u32*>(MCU::DMAMUX1_BASE) };
+
+                MCU::DMA_CH const   ch_;
+
+                auto&
+chReg           (){ return reg_.CH[ch_]; }
+
+public:
+
+                enum { //CCR
+                    ENbm = 1, TCIE = 1<<1, HTIE = 1<<2, TEIE = 1<<3,
+                    MEM2PERIPH = 1<<4, PERIPH2MEM = 0, CIRC = 1<<5, MINCbm = 1<<7
+                    };
+
+                enum { GIF = 1, TCIF = 1<<1, HTIF = 1<<2, TEIF = 1<<3, ALLF = 15 }; //flags (ISR/IFCR)
+
+DmaChannel      (MCU::DMA_CH ch, MCU::DMAREQ req)
+                : ch_( ch )
+                {
+                if( ch_ == MCU::DMA_NONE ) return;
+                { InterruptLock lock; MCU::RCCreg.AHBENR or_eq MCU::RCC_DMA1ENbm; } //rcc
+                chReg().CCR = 0;
+                dmamuxCCR_[ch_] = req; //dmamux channel = dma channel-1
+                }
+
+                //not used (no channel)
+DmaChannel      () : ch_( MCU::DMA_NONE ) {}
+
+                auto
+isUsed          (){ return ch_ != MCU::DMA_NONE; }
+
+                MCU::IRQn
+irqn            ()
+                {
+                return ch_ == MCU::DMA1_CH1 ? MCU::DMA1_CH1_IRQ :
+                       ch_ <= MCU::DMA1_CH3 ? MCU::DMA1_CH2_3_IRQ : MCU::DMA1_CH4_5_IRQ;
+                }
+
+                //start a transfer of n bytes, mem incrementing, options- direction,
+                //CIRC, irq enables (any previous transfer is stopped, flags cleared)
+                void
+start           (volatile u32* periph, const void* mem, u32 n, u32 options)
+                {
+                auto& r = chReg();
+                r.CCR = 0;
+                clear();
+                r.CPAR = reinterpret_cast<u32>(periph);
+                r.CMAR = reinterpret_cast<u32>(mem);
+                r.CNDTR = n;
+                r.CCR = options bitor MINCbm bitor ENbm;
+                }
+
+                void
+stop            (){ chReg().CCR = 0; }
+
+                //bytes not yet transferred
+                u32
+remaining       (){ return chReg().CNDTR; }
+
+                u32
+flags           (){ return (reg_.ISR >> (ch_*4)) bitand ALLF; }
+
+                void
+clear           (u32 f = ALLF){ reg_.IFCR = f << (ch_*4); }
+
+                }; //DmaChannel
+
+//........................................................................................
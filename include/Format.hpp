@@ -0,0 +1,233 @@
+#pragma once
+
+#include "Util.hpp"
+#include "Print.hpp"
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+//........................................................................................
+
+                // compile time format strings for FMT::Print
+                // the format string is parsed at compile time (any error is a compile error),
+                // and each field is emitted with its options as constants- no Print format
+                // state is used or changed
+
+                //  FMT::format<"{:>6} [{:#010X}] {}\n">( uart, a, b, "text" );
+                //      ->    123 [0x0000ABCD] text
+
+                // field- {} or {:[[fill]align][sign][#][0][width][type]}
+                //  align   < left, > right, ^ center (default- numbers right, strings left)
+                //  sign    + (also +0), - (default), space
+                //  #       prefix 0x (x,X), 0b (b), 0 (o, if not 0)- the prefix is always
+                //          lowercase (uppercase only applies to the hex digits, as in Print)
+                //  0       0 pad after the sign/prefix (ignored if align given)
+                //  width   min total width, including sign/prefix
+                //  type    d x X o b (integer), c (char), s (string/bool)
+                //  {{ }}   literal { }
+
+                // integers (and char/bool with an integer type), strings (const char*,
+                // string_view), char, bool (true/false with no type or s)
+                // any other type (double, time_point, etc.) needs a plain {} and is printed
+                // with operator<< (which does use the Print format state)
+
+//........................................................................................
+
+////////////////
+namespace
+FMT
+////////////////
+                {
+
+                //string literal as a template parameter
+                template<unsigned N>
+                struct FixedString {
+                    char s[N]{};
+                    constexpr FixedString(const char (&str)[N]){ for( unsigned i = 0; i < N; i++ ) s[i] = str[i]; }
+                    };
+
+                enum FORMAT_ERR { FORMAT_OK, FORMAT_BRACE, FORMAT_FIELD };
+
+                struct FormatField {
+                    u32     litPos, litLen;     //literal text before this field
+                    char    fill{ ' ' };
+                    char    align{ 0 };         //0 = default for the type
+                    char    sign{ '-' };
+                    bool    alt{ false };       //#
+                    bool    zero{ false };      //0
+                    u32     width{ 0 };
+                    char    type{ 0 };          //0 = none
+                    };
+
+                //parse result, literals (with {{ }} resolved) are stored in lit
+                template<unsigned N>
+                struct FormatParsed {
+                    char        lit[N]{};
+                    u32         litN{ 0 };
+                    FormatField field[N/2+1]{};
+                    u32         count{ 0 };
+                    u32         tailPos{ 0 }, tailLen{ 0 };
+                    FORMAT_ERR  err{ FORMAT_OK };
+                    };
+
+                template<unsigned N> constexpr FormatParsed<N>
+formatParse     (const FixedString<N>& F)
+                {
+                FormatParsed<N> r;
+                auto s = F.s;
+                u32 i = 0, litStart = 0;
+                auto isAlign = [](char c){ return c == '<' or c == '>' or c == '^'; };
+                while( i < N-1 ){
+                    auto c = s[i];
+                    if( c == '}' ){
+                        if( s[i+1] != '}' ){ r.err = FORMAT_BRACE; return r; }
+                        r.lit[r.litN++] = '}'; i += 2; continue;
+                        }
+                    if( c != '{' ){ r.lit[r.litN++] = c; i++; continue; }
+                    if( s[i+1] == '{' ){ r.lit[r.litN++] = '{'; i += 2; continue; }
+                    //field
+                    FormatField f{ litStart, r.litN - litStart };
+                    i++;
+                    if( s[i] == ':' ){
+                        i++;
+                        if( s[i] and s[i] != '}' and isAlign(s[i+1]) ){ f.fill = s[i]; f.align = s[i+1]; i += 2; }
+                        else if( isAlign(s[i]) ){ f.align = s[i]; i++; }
+                        if( s[i] == '+' or s[i] == '-' or s[i] == ' ' ){ f.sign = s[i]; i++; }
+                        if( s[i] == '#' ){ f.alt = true; i++; }
+                        if( s[i] == '0' ){ f.zero = not f.align; i++; }
+                        while( s[i] >= '0' and s[i] <= '9' ){ f.width = f.width*10 + s[i] - '0'; i++; }
+                        for( auto t : "dxXobcs" ) if( t and s[i] == t ){ f.type = t; i++; break; }
+                        }
+                    if( s[i] != '}' ){ r.err = FORMAT_FIELD; return r; }
+                    i++;
+                    r.field[r.count++] = f;
+                    litStart = r.litN;
+                    }
+                r.tailPos = litStart;
+                r.tailLen = r.litN - litStart;
+                return r;
+                }
+
+                //parsed once per format string
+                template<FixedString F>
+                struct FormatOf { static constexpr auto v{ formatParse(F) }; };
+
+//........................................................................................
+
+                //the emitters (a Print friend, so can write spans directly)
+////////////////
+struct
+Formatter
+////////////////
+                {
+
+                static void
+pad             (Print& p, char c, u32 n)
+                {
+                char fills[8];
+                for( auto& f : fills ) f = c;
+                for( ; n > 8; n -= 8 ) p.write_( fills, 8 );
+                p.write_( fills, n );
+                }
+
+                //text padded to width (align default- left)
+                template<FormatField f> static void
+text            (Print& p, std::string_view sv)
+                {
+                u32 n = f.width > sv.size() ? f.width - sv.size() : 0;
+                u32 lpad = f.align == '>' ? n : f.align == '^' ? n/2 : 0;
+                if( lpad ) pad( p, f.fill, lpad );
+                p.write_( sv.data(), sv.size() );
+                if( n - lpad ) pad( p, f.fill, n - lpad );
+                }
+
+                template<FormatField f, typename T> static void
+integer         (Print& p, T v)
+                {
+                using U = std::conditional_t< (sizeof(T) > sizeof(u32)), u64, u32 >;
+                constexpr auto base = f.type == 'x' or f.type == 'X' ? hex : f.type == 'o' ? oct : f.type == 'b' ? bin : dec;
+                bool neg = false;
+                U u = static_cast<U>(v);
+                if constexpr( std::is_signed_v<T> ){ neg = v < 0; if( neg ) u = U(0) - u; }
+                char buf[sizeof(U)*8+3];                    //digits, 2 prefix, sign
+                auto end = &buf[sizeof buf];
+                auto d = Print::digits( end, u, base, f.type == 'X' );
+                auto nd = static_cast<u32>(end - d);
+                if constexpr( f.alt ){
+                    if constexpr( base == hex ){ *--d = 'x'; *--d = '0'; }
+                    else if constexpr( base == bin ){ *--d = 'b'; *--d = '0'; }
+                    else if constexpr( base == oct ){ if( u ) *--d = '0'; }
+                    }
+                if( neg ) *--d = '-';
+                else if constexpr( f.sign == '+' ) *--d = '+';
+                else if constexpr( f.sign == ' ' ) *--d = ' ';
+                auto n = static_cast<u32>(end - d);
+                if constexpr( f.zero ){ //0 pad between sign/prefix and digits
+                    auto z = f.width > n ? f.width - n : 0;
+                    if( z ){
+                        p.write_( d, n - nd );
+                        pad( p, '0', z );
+                        p.write_( end - nd, nd );
+                        return;
+                        }
+                    }
+                constexpr FormatField fr{ f.litPos, f.litLen, f.fill, f.align ? f.align : '>', f.sign, f.alt, f.zero, f.width, f.type };
+                text<fr>( p, {d, n} );
+                }
+
+                template<FormatField f, typename T> static void
+field           (Print& p, const T& v)
+                {
+                constexpr bool isStr = std::is_convertible_v<const T&, std::string_view>;
+                constexpr bool isInt = std::is_integral_v<T>;
+                constexpr bool isNum = f.type and f.type != 'c' and f.type != 's';
+                constexpr bool plain = not f.type and not f.width and not f.alt and not f.zero and f.sign == '-';
+                if constexpr( std::is_same_v<T,bool> and not isNum ){
+                    static_assert( not f.type or f.type == 's', "FMT::format: bool field type must be none, s or an integer type" );
+                    text<f>( p, v ? "true" : "false" );
+                    }
+                else if constexpr( std::is_same_v<T,char> and not isNum ){
+                    static_assert( not f.type or f.type == 'c', "FMT::format: char field type must be none, c or an integer type" );
+                    text<f>( p, {&v, 1} );
+                    }
+                else if constexpr( isInt ){
+                    static_assert( f.type != 's' and f.type != 'c', "FMT::format: integer field type must be none, d, x, X, o or b" );
+                    integer<f>( p, v );
+                    }
+                else if constexpr( isStr ){
+                    static_assert( not f.type or f.type == 's', "FMT::format: string field type must be none or s" );
+                    text<f>( p, std::string_view(v) );
+                    }
+                else {
+                    static_assert( plain, "FMT::format: this type needs a plain {} field (printed with operator<<)" );
+                    p << v;
+                    }
+                }
+
+                template<FixedString F, typename... Ts, u32... I> static Print&
+emit            (Print& p, std::integer_sequence<u32, I...>, const Ts&... args)
+                {
+                constexpr auto& r = FormatOf<F>::v;
+                ( ( p.write_( &r.lit[r.field[I].litPos], r.field[I].litLen ), field<r.field[I]>( p, args ) ), ... );
+                p.write_( &r.lit[r.tailPos], r.tailLen );
+                return p;
+                }
+
+                }; //Formatter
+
+//........................................................................................
+
+                template<FixedString F, typename... Ts> Print&
+format          (Print& p, const Ts&... args)
+                {
+                constexpr auto& r = FormatOf<F>::v;
+                static_assert( r.err != FORMAT_BRACE, "FMT::format: unmatched } (use }} for a literal })" );
+                static_assert( r.err != FORMAT_FIELD, "FMT::format: bad {} field, use {:[[fill]align][sign][#][0][width][type]}" );
+                static_assert( r.count == sizeof...(Ts), "FMT::format: number of {} fields and arguments do not match" );
+                return Formatter::emit<F>( p, std::make_integer_sequence<u32, sizeof...(Ts)>{}, args... );
+                }
+
+                } //FMT
+
+//........................................................................................
@@ -2,6 +2,7 @@
 
 #include "Util.hpp"
 #include "System.hpp"
+#include "ClockEpoch.hpp"
 #include <chrono>
 #include MY_MCU_HEADER
 
@@ -38,10 +39,33 @@ Lptim1ClockLSI
                 static inline Nvic::IRQ_PRIORITY    irqPriority_;
                 static inline CPU::Atom<i64>        atom_lsiCyclesTotal_;
                 static inline volatile bool         wasIrq_; //can see if was cause of wakeup
+                static inline volatile bool         wasCmp_; //compare irq seen (for wakeup latency)
+                static inline bool                  isWakeArmed_; //compare set by nextWakeup, not yet seen
+                static inline i64                   wakeAt_; //lsi cycle count compare was set to
+                static inline u32                   latencyQ3_; //average wakeup latency, lsi cycles x8
 
                 //consts
                 static constexpr auto lsiHz_{ 32768 };  
                 static constexpr auto cyclesPerIrq_{ duration_irq::period::num * lsiHz_ / duration_irq::period::den };                
+                //wakeup latency samples larger than this are not a compare wakeup we set
+                //(compare also matches once per lptim period, whether we wanted it or not)
+                static constexpr i64 LATENCY_MAX_{ 32 }; //~1ms
+
+                //time resumed from after a reset (0 if power on), added to all times
+                static inline const duration_chrono epoch_{ ClockEpoch::resume() };
+
+                //lsi cycles to us conversion is piecewise linear from a base point, which
+                //is moved forward at each overflow irq (so the rate can be changed without
+                //a time jump, and the product below stays small)
+                //  us = baseUs_ + (baseFrac_ + (cycles - baseCyc_) * usPerCycQ32_) >> 32
+                //nominal rate is 1e6/32768 us per cycle (exact in Q32), adjust() changes the 
+                //rate by ppb, step() moves the time forward
+                static constexpr u64 USPERCYC_Q32_{ (static_cast<u64>(duration_chrono::period::den)<<32) / lsiHz_ };
+                static inline i64                   baseCyc_;
+                static inline i64                   baseUs_{ epoch_.count() };
+                static inline u32                   baseFrac_; //Q32 fraction of a us
+                static inline u64                   usPerCycQ32_{ USPERCYC_Q32_ };
+                static inline i32                   ppb_; //current rate adjustment
 
                 static void 
 compare         (u16 v){ reg_.ICR = CMPbm; reg_.CMP = v; } //clear flag first
@@ -58,9 +82,12 @@ isr             ()
                 if( flags bitand ARRbm ){ //overflow
                     atom_lsiCyclesTotal_.value += cyclesPerIrq_;  
                     wasIrq_ = true;                  
+                    rebase( atom_lsiCyclesTotal_.value );
+                    checkpoint();
                     }
                 if( flags bitand CMPbm ){ //compare (used just to wakeup and set wasIrq_)
                     wasIrq_ = true; 
+                    wasCmp_ = true;
                     }              
                 }
 
@@ -90,21 +117,73 @@ lsiCycles       ()
                 }
 
 
-                //lsi cycles to chrono duration (duration_chrono)
-                //ratio's used for this chrono clock are always <num=1,den=n>,
-                //so will only need period::den
+                //lsi cycles to chrono duration (duration_chrono), cyc can be before
+                //baseCyc_ (a time before the last rebase)- the delta is signed, so cyc
+                //has to be within ~35 minutes of baseCyc_ (rebased every lptim period)
+                //(irq's off or in isr)
+                static duration_chrono
+cycles2chrono   (i64 cyc)
+                { 
+                auto q = baseFrac_ + (cyc - baseCyc_) * static_cast<i64>(usPerCycQ32_);
+                return duration_chrono( baseUs_ + (q>>32) ); //(>> of a negative q rounds down)
+                }
                 static auto
 cycles2chrono   ()
                 { 
-                auto cyc = lsiCycles();
-                return duration_chrono( cyc * duration_chrono::period::den / lsiHz_ );
+                InterruptLock lock;
+                return cycles2chrono( lsiCycles() );
                 }
-                static auto
+
+                //chrono time to lsi cycles, rounded up so a compare set to this value will
+                //not wake before d (+1 if rate adjusted, as the inverse is not exact)
+                //(irq's off)
+                static i64
 chrono2cycles   (duration_chrono d)
                 { 
-                return d.count() * lsiHz_ / duration_chrono::period::den;
+                constexpr i64 B{ 1'000'000'000 };
+                auto us = d.count() - baseUs_;
+                auto cyc = (us * lsiHz_ + duration_chrono::period::den - 1) / duration_chrono::period::den;
+                if( ppb_ ) cyc = cyc * B / (B + ppb_) + 1;
+                return baseCyc_ + cyc;
+                }
+
+                //move base point to cyc (irq's off or in isr)
+                static void
+rebase          (i64 cyc)
+                {
+                auto q = baseFrac_ + static_cast<u64>(cyc - baseCyc_) * usPerCycQ32_;
+                baseUs_ += static_cast<i64>(q>>32);
+                baseFrac_ = static_cast<u32>(q);
+                baseCyc_ = cyc;
+                }
+
+                //save the time at the end of the current lptim period (the highest
+                //time now() can return before the next checkpoint)
+                static void
+checkpoint      ()
+                {
+                auto cyc = atom_lsiCyclesTotal_.value + cyclesPerIrq_;
+                ClockEpoch::checkpoint( cycles2chrono(cyc).count() );
+                }
+
+                //called when a compare irq was seen, if it was the wakeup set by nextWakeup 
+                //the time from the compare match to now is the wakeup latency (wfi exit, 
+                //lptim isr, and whatever ran before we got here), keep a running average
+                //so nextWakeup can arm the compare that much early for low jitter tasks
+                static void
+latencyUpdate   ()
+                {
+                if( not isWakeArmed_ ) return;
+                isWakeArmed_ = false;
+                auto late = lsiCycles() - wakeAt_;
+                if( late < 0 or late > LATENCY_MAX_ ) return; //not our wakeup
+                latencyQ3_ = latencyQ3_ - (latencyQ3_>>3) + late; //avg = 7/8 avg + 1/8 new
                 }
 
+                //number of lsi cycles to wake early (average latency, rounded up)
+                static i64
+latencyCycles   (){ return (latencyQ3_ + 7) >> 3; }
+
                 static auto
 restart         (Nvic::IRQ_PRIORITY irqPriority = DEFAULT_PRIORITY)
                 {                
@@ -117,6 +196,7 @@ restart         (Nvic::IRQ_PRIORITY irqPriority = DEFAULT_PRIORITY)
                 compare(32); //can only be set when lptim enabled
                 reg_.CR or_eq 4; //CNTSTRT, can only be set when lptim enabled
                 reg_.ARR = 0xFFFF; //ARR can be set only when lptim enabled
+                checkpoint();
                 }
 
                 static auto
@@ -131,6 +211,7 @@ onCheck         ()
                 //restart() and callback() functions are primarily in mind so only specific
                 //function(s) are allowed to restart systick or set a callback, for example
                 friend int main();
+                friend struct ClockBench; //Benchmark.hpp, times the private functions
 public:
 
                 //these types will allow us to use Lptim as a chrono clock
@@ -147,6 +228,11 @@ now             ()
                 return time_point( cycles2chrono() ); 
                 }
 
+                //time the clock resumed from after a software reset, which is where
+                //the time discontinuity is (0 if started from power on)
+                static time_point
+epoch           (){ return time_point( epoch_ ); }
+
                 //TODO-
                 //if irq's are off, delay may never return
                 //TODO
@@ -166,20 +252,68 @@ wasIrq          ()
                 InterruptLock lock;
                 bool ret = wasIrq_;
                 wasIrq_ = false; 
+                if( wasCmp_ ){ wasCmp_ = false; latencyUpdate(); }
                 return ret; 
                 }
 
-//in progress
-                static void 
-nextWakeup      (time_point t)
+                //how early nextWakeup arms the compare when asked to (average wakeup
+                //latency, +1 lsi cycle as the wakeup time is rounded up to the next cycle)
+                //a task scheduler can busy-wait a task that is due within this duration
+                static duration
+wakeupLatency   ()
+                {
+                InterruptLock lock;
+                return duration( (latencyCycles()+1) * duration_chrono::period::den / lsiHz_ );
+                }
+
+                //set compare to wakeup at time t (rounded up to the next lsi cycle), or
+                //if early is true, wakeup earlier by the average wakeup latency (so the
+                //caller can busy-wait the remaining time to get a low jitter run time)
+                //returns the time the wakeup is set for
+                static time_point
+nextWakeup      (time_point t, bool early = false)
                 {
                 InterruptLock lock;
-                //if time already passed, set wasIrq_ and clear compare flag
-                if( t <= now() ){        
-                    wasIrq_ = true;     //set wasIrq_
-                    //just leave compare unchanged
+                auto cyc = chrono2cycles( t.time_since_epoch() );
+                if( early ) cyc -= latencyCycles();
+                //if time already passed, set wasIrq_ and leave compare unchanged
+                //(t can be far in the past, a task that kept its runat, so t is
+                //returned as-is and not converted back from cyc)
+                if( cyc <= lsiCycles() ){        
+                    wasIrq_ = true;
+                    isWakeArmed_ = false;
+                    return t;
                     }
-                else compare( chrono2cycles(t.time_since_epoch()) ); 
+                compare( cyc );
+                wakeAt_ = cyc;
+                isWakeArmed_ = true;
+                return time_point( cycles2chrono(cyc) );
+                }
+
+                //clock discipline (used by ClockSync to correct the lsi clock to a host clock)
+
+                //change the clock rate by ppb (parts per billion, + is faster), the time
+                //is continuous through the change
+                static void
+adjust          (i32 ppb)
+                {
+                InterruptLock lock;
+                rebase( lsiCycles() );
+                ppb_ = ppb;
+                //USPERCYC_Q32_ is a multiple of 1000, so ppb applied in 2 steps to stay in 64bits
+                usPerCycQ32_ = USPERCYC_Q32_ + static_cast<i64>(USPERCYC_Q32_/1000) * ppb / 1'000'000;
+                }
+                static i32
+adjust          (){ return ppb_; }
+
+                //move the time forward (a negative step is ignored- the clock is
+                //monotonic, so a slow clock is corrected with adjust() instead)
+                static void
+step            (duration d)
+                {
+                if( d.count() <= 0 ) return;
+                InterruptLock lock;
+                baseUs_ += d.count();
                 }
 
                 }; // Lptim1ClockLSI
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Util.hpp"
+#include "System.hpp"
+#include <chrono>
+#include MY_MCU_HEADER
+
+
+//........................................................................................
+
+                // the Tasks scheduler runs tasks from the idle loop, so anything that needs
+                // to happen at an exact time inherits the jitter of whatever task is running
+                // this class multiplexes a 32bit timer compare channel (CC1) so any number
+                // (up to N) of one-shot callbacks can be run from the timer isr, at the irq
+                // priority given in the constructor
+
+                // the timer counts at 1MHz (1us resolution), free running 32bits
+                // (wraps at ~71 minutes, so the max time out is ~35 minutes)
+
+                //callbacks run in the timer isr, so keep them short-
+                //      OneShotTimers<8> timers{ MCU::Tim2, Nvic::PRIORITY0 };
+                //      timers.after( 500us, []{ board.debugPin.toggle(); } );
+                //time from a known tick value (like one read in a pin change isr)-
+                //      auto t = timers.ticks();
+                //      timers.at( t + 500, []{ board.debugPin.toggle(); } );
+                //a callback can call after()/at() to run again (periodic)
+
+////////////////
+template
+<int N>         //max number of pending callbacks
+class
+OneShotTimers   : public CPU::Isr
+////////////////
+                {
+
+                //no atomic protection needed as none of these registers are shared
+                //with any other timer instance
+                struct Reg { u32 CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR,
+                             reserved0_, CCR1, CCR2, CCR3, CCR4; };
+
+                enum { CENbm = 1, UGbm = 1, CC1Gbm = 1<<1, CC1IEbm = 1<<1, CC1IFbm = 1<<1 };
+
+                static constexpr u32 TICKHZ_{ 1'000'000 }; //1us
+
+                struct Timer { u32 at; vvfunc_t func; };
+
+                volatile Reg&       reg_; //need volatile as Reg struct members are not
+                Timer               list_[N]; //sorted, soonest first
+                int                 count_{ 0 };
+
+                //wrap safe- at is in the past or now
+                bool
+isDue           (u32 at){ return static_cast<i32>(reg_.CNT - at) >= 0; }
+
+                void
+removeAt        (int i)
+                {
+                for( count_--; i < count_; i++ ) list_[i] = list_[i+1];
+                }
+
+                //set compare to the soonest timer, or turn off irq if nothing left
+                //(called with irq's off or from isr)
+                void
+arm             ()
+                {
+                if( count_ == 0 ){ reg_.DIER = 0; return; }
+                reg_.CCR1 = list_[0].at;
+                reg_.DIER = CC1IEbm;
+                //if already passed (or passed while setting CCR1), generate the compare
+                //event so the isr runs it (callbacks always run in the isr)
+                if( isDue(list_[0].at) ) reg_.EGR = CC1Gbm;
+                }
+
+                //pop the first timer if due (irq's off, as at()/cancel() can be called
+                //from a higher priority isr), nullptr if none due
+                vvfunc_t
+popDue          ()
+                {
+                InterruptLock lock;
+                if( count_ == 0 or not isDue(list_[0].at) ) return nullptr;
+                auto f = list_[0].func;
+                removeAt( 0 ); //remove first, so callback can add itself again
+                return f;
+                }
+
+                // compare match -> run all due callbacks (outside the lock)
+                void
+isr             () override
+                {
+                reg_.SR = compl CC1IFbm; //rc_w0, clear flag before checking list
+                while( auto f = popDue() ) f();
+                InterruptLock lock;
+                arm();
+                }
+
+                auto
+prescale        (){ reg_.PSC = System::cpuHz()/TICKHZ_ - 1; reg_.EGR = UGbm; } //UG loads PSC
+
+public:
+
+                using duration = std::chrono::microseconds;
+
+OneShotTimers   (MCU::tim_t t, Nvic::IRQ_PRIORITY irqPriority = Nvic::PRIORITY0)
+                : reg_( *(reinterpret_cast<Reg*>(t.addr)) )
+                {
+                { InterruptLock lock; t.init(); } //rcc
+                reg_.CR1 = 0;
+                reg_.ARR = 0xFFFFFFFF; //free running, full 32bits
+                prescale();
+                reg_.SR = 0;
+                Nvic::setFunction( t.irqn, this, irqPriority );
+                reg_.CR1 = CENbm;
+                }
+
+                //cpu speed changed, recompute prescaler (UG also resets the counter,
+                //so any pending timers will be late- update before use)
+                auto
+cpuSpeedUpdate  (){ InterruptLock lock; prescale(); }
+
+                //current tick count (1us per tick)
+                u32
+ticks           (){ return reg_.CNT; }
+
+                //run f at tick count tick (wrap safe, can be up to ~35 minutes away)
+                //returns false if no room in list
+                bool
+at              (u32 tick, vvfunc_t f)
+                {
+                InterruptLock lock;
+                if( count_ >= N ) return false;
+                u32 now = reg_.CNT;
+                auto fromNow = [now](u32 t){ return static_cast<i32>(t - now); };
+                auto i = count_;
+                //sorted insert (compare as time from now, so wrap is not a problem)
+                for( ; i > 0 and fromNow(list_[i-1].at) > fromNow(tick); i-- ) list_[i] = list_[i-1];
+                list_[i] = { tick, f };
+                count_++;
+                if( i == 0 ) arm(); //new soonest
+                return true;
+                }
+
+                //run f after duration d
+                bool
+after           (duration d, vvfunc_t f){ return at( ticks() + d.count(), f ); }
+
+                //remove all pending f callbacks, returns number removed
+                int
+cancel          (vvfunc_t f)
+                {
+                InterruptLock lock;
+                auto n = 0;
+                for( auto i = 0; i < count_; ){
+                    if( list_[i].func != f ){ i++; continue; }
+                    removeAt( i );
+                    n++;
+                    }
+                arm();
+                return n;
+                }
+
+                int
+pending         (){ return count_; }
+
+                }; //OneShotTimers
+
+//........................................................................................
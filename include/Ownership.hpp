@@ -8,8 +8,9 @@
 
 ////////////////
 template
-<typename T>    //device (device requires an isIdle() function- returns true when its 
+<typename T,    //device (device requires an isIdle() function- returns true when its 
                 //ready to take on a new owner, or simply returns true
+ int W = 4>     //waiter list size
 class           
 Ownership
 ////////////////
@@ -18,6 +19,51 @@ Ownership
                 u32 owner_{1}; //unique id, excluding 0
                 T& dev_;
                 bool isOwned_{ false };               
+
+                //waiters (fifo), the first waiter is the only one that can open the
+                //device while there are waiters- it is notified when the device is closed
+                //(and when the device goes idle, see deviceIdle), so a waiting caller
+                //does not have to keep trying
+                //a waiter has to keep opening until it gets the device, or call
+                //cancelWait when it gives up (like before its task is removed)- a waiter
+                //that goes away without it blocks the waiters behind it, and all users
+                //that check hasWaiters (UartMux)
+                //(the list is also used from deviceIdle, which can be an isr)
+                using notify_t = void(*)(u32 waiter);
+                u32 waiters_[W]{};
+                u8 waitIdx_{ 0 };
+                u8 waitCount_{ 0 };
+                notify_t notify_{ nullptr };
+                bool const idleEvent_; //device calls deviceIdle when it goes idle
+
+                bool
+isFirst         (u32 waiter){ return waitCount_ and waiters_[waitIdx_] == waiter; }
+
+                void
+addWaiter       (u32 waiter)
+                {
+                InterruptLock lock;
+                for( u8 i = 0; i < waitCount_; i++ ) if( waiters_[(waitIdx_ + i) % W] == waiter ) return;
+                if( waitCount_ >= W ) return; //list full, caller has to retry on its own
+                waiters_[(waitIdx_ + waitCount_) % W] = waiter;
+                waitCount_++;
+                }
+
+                void
+removeFirst     ()
+                {
+                InterruptLock lock;
+                if( not waitCount_ ) return;
+                if( ++waitIdx_ >= W ) waitIdx_ = 0;
+                waitCount_--;
+                }
+
+                void
+notifyFirst     ()
+                {
+                if( waitCount_ and notify_ ) notify_( waiters_[waitIdx_] );
+                }
+
 public:
 
                 struct Descriptor {
@@ -25,24 +71,44 @@ public:
                     T* dev; //device pointer
                     };
 
-Ownership       (T& dev)
-                : dev_( dev )
+                //idleEvent- true if the device calls deviceIdle() when it goes idle (so
+                //a waiter can also wait for the device to finish after a close)
+Ownership       (T& dev, bool idleEvent = false)
+                : dev_( dev ), idleEvent_( idleEvent )
                 {}
 
                 //if no id passed in, assume is not a current owner
+                //waiter- a unique id (not 0) for the caller to be put in the waiter
+                //list if the device is not available (and notified when it is its turn,
+                //see setNotify), 0 = not put in the waiter list
                 Descriptor
-open            (u32 id = 0)
+open            (u32 id = 0, u32 waiter = 0)
                 {
                 if( id == owner_ ){     //caller already owns
                     return {owner_,&dev_};
                     }
-                if( isOwned_ ) return {0,0};
+                bool myTurn = waitCount_ == 0 or isFirst(waiter);
+                { //(the idle check and waiter add with irq's off, so a deviceIdle from
+                  // the device isr cannot come between them and be missed)
+                InterruptLock lock;
+                if( isOwned_ or not myTurn or not dev_.isIdle() ){
+                    if( waiter ) addWaiter( waiter );
+                    return {0,0};
+                    }
+                }
                 // device ownership available
-                if( not dev_.isIdle() ) return {0,0};  //device idle check failed
+                if( waiter ) removeFirst();
                 isOwned_ = true;
                 return {owner_,&dev_};
                 }
 
+                auto
+isOwned         (){ return isOwned_; }
+                //waiters queued for the device (others should stay off it, so the first
+                //waiter can see it idle)
+                bool
+hasWaiters      (){ return waitCount_ != 0; }
+
                 Descriptor
 close           (Descriptor od)
                 {
@@ -51,9 +117,54 @@ close           (Descriptor od)
                 if( od.id != owner_ ) return od;  //only owner can release
                 if( ++owner_ == 0 ) owner_ = 1; //inc owner_ (to invalidate id), owner_cannot be 0
                 isOwned_ = false; 
+                notifyFirst();
                 return {0,0};
                 }
 
+                //the device went idle (called by the device event, like uart tx
+                //complete)- the first waiter is notified if the device is not owned
+                void
+deviceIdle      ()
+                {
+                if( not isOwned_ ) notifyFirst();
+                }
+
+                //true if the waiter is in the waiter list and will be notified, false if
+                //not in the list, or it is the first waiter and the device is not owned
+                //and has no idle event (only not idle yet, no close to come)- the caller
+                //has to try again on its own
+                bool
+isWaiting       (u32 waiter)
+                {
+                InterruptLock lock;
+                if( isFirst(waiter) ) return isOwned_ or idleEvent_;
+                for( u8 i = 1; i < waitCount_; i++ ) if( waiters_[(waitIdx_ + i) % W] == waiter ) return true;
+                return false;
+                }
+
+                //take a waiter out of the waiter list (it gives up waiting), if it was
+                //first the next waiter is notified if the device is not owned
+                void
+cancelWait      (u32 waiter)
+                {
+                if( not waiter ) return;
+                bool wasFirst;
+                {
+                InterruptLock lock;
+                u8 i = 0;
+                while( i < waitCount_ and waiters_[(waitIdx_ + i) % W] != waiter ) i++;
+                if( i == waitCount_ ) return; //not in the list
+                wasFirst = i == 0;
+                for( waitCount_--; i < waitCount_; i++ ) waiters_[(waitIdx_ + i) % W] = waiters_[(waitIdx_ + i + 1) % W];
+                }
+                if( wasFirst and not isOwned_ ) notifyFirst();
+                }
+
+                //how a waiter is notified (as void(u32 waiter))-
+                //      board.uart.setNotify( [](u32 w){ Tasks_t::notify(w); } );
+                auto
+setNotify       (notify_t f){ notify_ = f; }
+
                 }; //Ownership
 
 //........................................................................................
@@ -96,10 +207,12 @@ class Open      {
                 // using ottype_t = Ownership<T>;
                 Ownership<T>::Descriptor desc_{0,0}; //u32 id; T* dev;
                 Ownership<T>& own_;
+                u32 waiter_;
 public:
 
-Open            (Ownership<T>& own) 
-                : own_(own) 
+                //waiter- optional unique id (not 0) to wait in line (see Ownership::open)
+Open            (Ownership<T>& own, u32 waiter = 0) 
+                : own_(own), waiter_(waiter) 
                 {
                 //constructor may run when not wanted if class object is static
                 //so do not attempt to own device here via dev()
@@ -109,14 +222,21 @@ Open            (Ownership<T>& own)
                 T*
 pointer         ()
                 { 
-                if( not desc_.dev ) desc_ = own_.open();
+                if( not desc_.dev ) desc_ = own_.open( 0, waiter_ );
                 return desc_.dev; 
                 }
 
+                //not opened, will be notified when it is our turn
+                bool
+isWaiting       (){ return waiter_ and own_.isWaiting( waiter_ ); }
+
+                //close if opened, else give up waiting (a waiter that no longer wants
+                //the device has to call this, see Ownership::cancelWait)
                 T* 
 close           ()
                 { 
                 if( desc_.dev ) desc_ = own_.close(desc_);
+                else own_.cancelWait( waiter_ );
                 return desc_.dev;
                 }
 
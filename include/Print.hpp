@@ -3,6 +3,9 @@
 #include "Util.hpp"
 #include <string_view>
 #include <limits>
+#include <type_traits>
+#include <chrono>
+#include <bit>
 
 
 //........................................................................................
@@ -28,6 +31,11 @@ FMT
                 enum FMT_COUNTCLR   { countclr };                               //clear char out count
                 enum FMT_ENDL2      { endl2 };                                  //endl x2
 
+                //fixed point values (raw), print as a double would (precision, width, etc.)
+                //  uart << FMT::Q16{ 0x0001'8000 };   -->> 1.500000000
+                struct Q16 { i32 v; };  //Q16.16
+                struct Q32 { i64 v; };  //Q32.32
+
 
 //........................................................................................
 
@@ -37,64 +45,116 @@ Print
 ////////////////
                 {
 
-                //no true 64bit support, but if a 64bit value can be converted to a
-                //u32/i32 without truncation it will be processed, otherwise ignored
-                //for now
-
                 //constant values
                 enum { PRECISION_MAX = 9 }; //max float precision, limited to 9 by use of 32bit integers in calculations
 
-public:
+                //high 32bits of a 32x32 multiply, from 16x16 multiplies (the M0+ has a 
+                //single cycle 32bit multiply, but no 64bit result- a u64 multiply would
+                //be a libgcc call)
+                static constexpr u32
+mulhi           (u32 a, u32 b)
+                {
+                u32 al = a bitand 0xFFFF, ah = a >> 16, bl = b bitand 0xFFFF, bh = b >> 16;
+                u32 lh = al*bh, hl = ah*bl;
+                u32 mid = ((al*bl) >> 16) + (lh bitand 0xFFFF) + (hl bitand 0xFFFF);
+                return ah*bh + (lh >> 16) + (hl >> 16) + (mid >> 16);
+                }
 
-                //print a string_view (which also contains size info)
-                Print&
-print           (std::string_view sv)
+                //v/100 for any u32 (ceil(2^37/100) reciprocal)
+                static constexpr u32
+div100          (u32 v){ return mulhi( v, 0x51EB'851F ) >> 5; }
+
+                //64bit versions from the above (64bit add/shift is inline, multiply and
+                //divide are libgcc calls)
+                static constexpr u64
+mul64           (u32 a, u32 b){ return (static_cast<u64>(mulhi( a, b )) << 32) bitor (a*b); }
+
+                static constexpr u64
+mulhi64         (u64 a, u64 b)
                 {
-                int pad = width_ - sv.size();
-                width_ = 0;                                     //always reset after use
-                isNeg_ = false;                                 //clear for the other 2 functions (since they both will end up here)
-                auto wr = [&]{ for( char c : sv ) write_( c ); }; //function to write the string
-                if( pad <= 0 or just_ == left ) wr();           //print sv first
-                if( pad > 0 ){                                  //need to deal with padding
-                    while( pad-- > 0 ) write_( fill_ );         //print any needed padding
-                    if( just_ == right ) wr();                  //and print sv if was not done already
+                u32 a0 = a, a1 = a >> 32, b0 = b, b1 = b >> 32;
+                u64 lh = mul64( a0, b1 ), hl = mul64( a1, b0 );
+                u64 mid = (mul64( a0, b0 ) >> 32) + static_cast<u32>(lh) + static_cast<u32>(hl);
+                return mul64( a1, b1 ) + (lh >> 32) + (hl >> 32) + (mid >> 32);
+                }
+
+                //v/1e9 for any u64 (1e9 = 2^9*1953125, so divide by 2^9 first, then
+                //reciprocal multiply by ceil(2^75/1953125))
+                static constexpr u64
+div1e9          (u64 v){ return mulhi64( v >> 9, 0x0044'B82F'A09B'5A53 ) >> 11; }
+
+                //decimal u32 into buffer ending at p (p decrements), at least nmin digits (0 padded)
+                //2 digits at a time (/100 by reciprocal multiply), then 1 or 2 left
+                static char*
+dec32           (char* p, u32 u, u32 nmin)
+                {
+                struct Digits2 { char d[200]; };                //"00".."99", 2 decimal digits per lookup
+                static constexpr Digits2 digits2{ []{ Digits2 t{}; for( auto i = 0; i < 100; i++ ){ 
+                    t.d[i*2] = '0'+i/10; t.d[i*2+1] = '0'+i%10; } return t; }() };
+                auto end = p;
+                while( u >= 100 ){
+                    u32 q = div100( u );
+                    auto d2 = &digits2.d[(u - q*100)*2];
+                    *--p = d2[1]; *--p = d2[0];
+                    u = q;
                     }
-                return *this;
+                if( u >= 10 ){ *--p = digits2.d[u*2+1]; *--p = digits2.d[u*2]; }
+                else *--p = '0' + u; 
+                while( static_cast<u32>(end - p) < nmin ) *--p = '0';
+                return p;
                 }
-                
-                //const char* without size info, convert to string_view
-                //hopefully compiler produces the strlen at compile time (?) since
-                //it knows the string literal size
-                Print&
-print           (const char* str){ return print( std::string_view{ str, __builtin_strlen(str)} ); }
 
-                //unsigned int (32bits), prints as string (to above string_view print function)
-                Print&
-print           (const u32 v)
+                //digits only of unsigned integer u (u32 or u64) into a buffer ending at end 
+                //(no sign, prefix or padding, format state not used), returns start of digits
+                //buffer needs to hold sizeof(T)*8 chars (bin)
+                template<typename T> static char*
+digits          (char* end, T u, FMT_BASE base, bool upper)
                 {
                 static constexpr char charTableUC[]{ "0123456789ABCDEF" };
                 static constexpr char charTableLC[]{ "0123456789abcdef" };
-                static constexpr u32 BUFSZ{ 32+2 };             //0bx...x-> 32+2 digits max (no 0 termination needed)
+                auto p = end;
+                //no hardware divide on the M0+, so avoid a divmod call per digit
+                if( base == dec ){
+                    if constexpr( sizeof(T) > sizeof(u32) ){
+                        //u64, 9 digit chunks (/1e9 by reciprocal multiply, no 64bit divide)
+                        while( u > 0xFFFFFFFF ){
+                            u64 q = div1e9( u );
+                            p = dec32( p, static_cast<u32>(u) - static_cast<u32>(q)*1'000'000'000, 9 ); //remainder in the low 32bits
+                            u = q;
+                            }
+                        }
+                    return dec32( p, static_cast<u32>(u), 1 );
+                    }
+                //bin/oct/hex are powers of 2, shift/mask
+                const char* ctbl{ upper ? charTableUC : charTableLC }; //use uppercase or lowercase char table
+                u32 sh = base == hex ? 4 : base == oct ? 3 : 1;
+                u32 mask = base - 1;
+                do{ //do at least once (u can be 0)
+                    *--p = ctbl[static_cast<u32>(u) bitand mask]; 
+                    u >>= sh;
+                    } while( u );
+                return p;
+                }
+
+                //unsigned integer (u32 or u64) to string, then to the string_view print function
+                template<typename T> Print&
+printU          (const T v)
+                {
+                static constexpr u32 BUFSZ{ sizeof(T)*8+2 };    //0bx...x-> bits+2 digits max (no 0 termination needed)
                 char buf[BUFSZ];                                //will be used as a string_view
-                u32 idx = BUFSZ;                                //start past end, so pre-decrement bufidx
-                const char* ctbl{ uppercase_ ? charTableUC : charTableLC }; //use uppercase or lowercase char table
-                auto u = v;                                     //make copy to use (v is const)
-                auto w = just_ == internal ? width_ : 0;        //use width_ here if internal justify
+                int w = just_ == internal ? width_ : 0;         //use width_ here if internal justify
                 if( w ){
                     width_ = 0;                                 //if internal, clear width_ so not used when value printed
                     just_ = right;                              //reset just_ if internal (so no need to reset in other code)
                     }                                           //(don't see where it would ever be useful to leave as internal)
 
+                u32 idx = digits( &buf[BUFSZ], v, base_, uppercase_ ) - buf;
+                w -= BUFSZ - idx;                               //digits count toward internal width
+
                 //function to insert char to buf (idx decrementing)
                 //buffer insert in reverse order (high bytes to low bytes)
                 auto insert = [&](char c){ buf[--idx] = c; }; 
 
-                do{ //do at least once (u can be 0)
-                    //group % / so compiler makes only 1 call to divmod (?)
-                    u32 rem = u % base_; u /= base_; 
-                    insert( ctbl[rem] ); 
-                    w--;
-                    } while( u );
                 //width_+internal justify could underflow buf, so limit width to allow for 2 more chars in buffer
                 while( w-- > 0 and (idx > 2) ) insert( fill_ ); //internal fill
 
@@ -110,31 +170,44 @@ print           (const u32 v)
                 return print( {&buf[idx], BUFSZ-idx} ); //call string_view version of print
                 }
 
-
-                //double, prints integer part and decimal part separately as integers
+                //sign, integer part and a binary fraction (frac/2^fbits, frac < 2^fbits) to
+                //decimal, precision_ decimal digits- frac*10^precision_ is a 96bit value
+                //(from 32x32 multiplies), the digits are the bits above fbits and the rest
+                //is the remainder used for rounding (exact, no bits are lost)
                 Print&
-print           (const double cd)
+printFixed      (bool neg, u32 di, u64 frac, u32 fbits)
                 {
-                static const char* errs[]{ "nan", "inf", "ovf" };
-                const char* perr{ nullptr };
-                //check for nan/inf
-                if( __builtin_isnan(cd) ) perr = errs[0];
-                else if( __builtin_isinf_sign(cd) ) perr = errs[1];
-                //we are limited by choice to using 32bit integers, so check for limits we can handle
-                //raw float value of 0x4F7FFFFF is 4294967040.0, and the next value we will exceed a 32bit integer
-                else if( cd > 4294967040.0 or (cd < -4294967040.0) ) perr = errs[2];
-                if( perr ){
-                    width_ = 0;
-                    return print( perr ); 
+                static constexpr u32 pow10[PRECISION_MAX+1]{ 
+                    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+                u32 m = pow10[precision_];
+                if( fbits < 64 ){ frac = fbits ? frac << (64 - fbits) : 0; fbits = 64; } //binary point above bit 63
+                u64 lo = mul64( static_cast<u32>(frac), m );
+                u64 hi = mul64( static_cast<u32>(frac >> 32), m );
+                u64 mid = (lo >> 32) + static_cast<u32>(hi);
+                u32 top = static_cast<u32>(hi >> 32) + static_cast<u32>(mid >> 32);   //product is top:low
+                u64 low = (mid << 32) bitor static_cast<u32>(lo);
+                u32 sh = fbits - 64;            //fraction bits in top
+                u32 ddi = 0;                    //decimal part as integer
+                int cmp = -1;                   //remainder compared to 0.5 (-1 less, 0 same, 1 more)
+                if( sh < 32 ){                  //else value too small to be anything but 0 (and < 0.5)
+                    ddi = top >> sh;
+                    u32 rtop = top bitand ((1u << sh) - 1);
+                    u32 htop = sh ? 1u << (sh - 1) : 0; //0.5 is htop:hlow
+                    u64 hlow = sh ? 0 : 1ULL << 63;
+                    cmp = rtop != htop ? (rtop > htop ? 1 : -1) : low != hlow ? (low > hlow ? 1 : -1) : 0;
                     }
 
-                isNeg_ = cd < 0;                // set isNeg_ for first integer print
-                double d { isNeg_ ? -cd : cd }; // [d]ouble, copy cd, any negative value to positive
-                u32 di { static_cast<u32>(d) }; // [d]ouble_as_[i]nteger, integer part to print
-                double dd { d - di };           // [d]ouble[d]ecimal part
-                u32 i09 { 0 };                  // current integer digit of decimal part x10
-                auto pre { precision_ };        // a copy to decrement 
-                u32 ddi { 0 };                  // [d]ouble[d]ecimal_as[i]nteger, conversion of decimal part to integer
+                //apply rounding rules  
+                //  round up/nearest if >0.5 remains
+                //  round to nearest even value if 0.5 remains
+                if( cmp > 0 or (cmp == 0 and ((precision_ ? ddi : di) bitand 1)) ){
+                    if( precision_ ) ddi++;     //inc integer-decimal part
+                    else di++ ;                 //inc integer part if no decimals in use
+                    }
+                if( precision_ and ddi == m ){  //decimal part rounded up to 1.0
+                    ddi = 0;
+                    di++;
+                    }
 
                 //first print integer part, uses pos_/isNeg_/width_/just_
                 //second decimal part (also imteger) needs pos_=noshowbase,just_=right,width_=precision_,fill_='0'
@@ -144,29 +217,10 @@ print           (const double cd)
                 auto pos_save = pos_;
                 auto save_fill = fill_;
 
-                //handle decimal part of float
-                while( pre-- ){                 //loop precision_ times
-                    dd *= 10;                   //shift each significant decimal digit into integer
-                    i09 = static_cast<u32>(dd); //integer 0-9
-                    ddi = ddi*10 + i09;         //shift in new integer to integer-decimal print value
-                    dd -= i09;                  //and remove the 0-9 integer (so only decimal remains)
-                    }
-
-                //apply rounding rules  
-                //  round up/nearest if >0.5 remains
-                //  round to nearest even value if 0.5 remains
-                if( dd > 0.5 ){
-                    if( precision_ ) ddi++;     //inc integer-decimal part
-                    else di++ ;                 //inc integer part if no decimals in use
-                    }
-                else if( dd == 0.5 ){
-                    if( precision_ ) ddi += i09 & 1;//make integer-decimal even based on last digit
-                    else di += di & 1;           //same, but on di since no decimals in use
-                    }
-
-                print( di );                   //print integer part of float
+                isNeg_ = neg;                   // set isNeg_ for first integer print
+                print( di );                    //print integer part
 
-                //if precision is not 0, print the decimal part of the float
+                //if precision is not 0, print the decimal part
                 if( precision_ ){
                     print( '.' ); 
                     pos_ = noshowpos;           //no +
@@ -182,6 +236,99 @@ print           (const double cd)
                 return *this;
                 }
 
+                //float or double from its bits- value is mantissa * 2^exponent, which is
+                //split into a u32 integer part and a binary fraction for printFixed
+                template<typename T> Print&
+printFloat      (const T v)
+                {
+                using B = std::conditional_t< sizeof(T) == sizeof(u64), u64, u32 >;
+                constexpr u32 MBITS{ std::numeric_limits<T>::digits - 1 };     //52 or 23 (hidden 1 not stored)
+                constexpr u32 EMAX{ sizeof(T) == sizeof(u64) ? 0x7FF : 0xFF };
+                constexpr int EBIAS{ std::numeric_limits<T>::max_exponent - 1 + MBITS }; //1075 or 150
+                //we are limited by choice to using 32bit integers, so check for limits we can handle
+                //raw float value of 0x4F7FFFFF is 4294967040.0, and the next value we will exceed a 32bit integer
+                constexpr B OVF{ std::bit_cast<B>(static_cast<T>(4294967040.0)) };
+                static const char* errs[]{ "nan", "inf", "ovf" };
+
+                B b{ std::bit_cast<B>(v) };
+                B mag{ b bitand (compl B(0) >> 1) };                            //no sign bit
+                u32 ex = mag >> MBITS;
+                u64 m = mag bitand ((B(1) << MBITS) - 1);
+                const char* perr{ nullptr };
+                if( ex == EMAX ) perr = m ? errs[0] : errs[1];                  //nan/inf
+                else if( mag > OVF ) perr = errs[2];
+                if( perr ){
+                    width_ = 0;
+                    return print( perr ); 
+                    }
+
+                if( ex ) m |= u64(1) << MBITS; else ex = 1;                     //normal has the hidden 1, subnormal does not
+                bool neg = (b != mag) and mag;                                  //-0.0 is not negative
+                int e = static_cast<int>(ex) - EBIAS;
+                if( e >= 0 ) return printFixed( neg, static_cast<u32>(m << e), 0, 0 ); //no fraction (fits, ovf checked)
+                u32 s = -e;                                                     //number of fraction bits in m
+                if( s >= 64 ) return printFixed( neg, 0, m, s );                //(m is at most 53 bits)
+                return printFixed( neg, static_cast<u32>(m >> s), m bitand ((u64(1) << s) - 1), s );
+                }
+
+
+public:
+
+                //print a string_view (which also contains size info)
+                Print&
+print           (std::string_view sv)
+                {
+                int pad = width_ - sv.size();
+                width_ = 0;                                     //always reset after use
+                isNeg_ = false;                                 //clear for the other 2 functions (since they both will end up here)
+                auto wr = [&]{ write_( sv.data(), sv.size() ); }; //function to write the string (as 1 span)
+                if( pad <= 0 or just_ == left ) wr();           //print sv first
+                if( pad > 0 ){                                  //need to deal with padding
+                    char fills[8];                              //print any needed padding, up to 8 at a time
+                    for( auto& c : fills ) c = fill_;
+                    for( ; pad > 8; pad -= 8 ) write_( fills, 8 );
+                    write_( fills, pad );
+                    if( just_ != left ) wr();                   //and print sv if was not done already (right/internal)
+                    }
+                return *this;
+                }
+                
+                //const char* without size info, convert to string_view
+                //hopefully compiler produces the strlen at compile time (?) since
+                //it knows the string literal size
+                Print&
+print           (const char* str){ return print( std::string_view{ str, __builtin_strlen(str)} ); }
+
+                //unsigned int (32bits), prints as string (to above string_view print function)
+                Print&
+print           (const u32 v){ return printU( v ); }
+
+                //unsigned 64bits, the faster 32bit version if it fits
+                Print&
+print           (const u64 v){ return v <= 0xFFFFFFFF ? printU( static_cast<u32>(v) ) : printU( v ); }
+
+                //double/float, integer part and decimal part printed separately as integers
+                //the value is taken from the bits (mantissa and exponent), so no soft float
+                //library calls are used (the M0+ has no fpu)
+                Print&
+print           (const double v){ return printFloat( v ); }
+                Print&
+print           (const float v){ return printFloat( v ); }
+
+                //fixed point, Q16.16 and Q32.32 (raw values), same output as a double
+                Print&
+print           (const Q16 q)
+                {
+                u32 u = q.v < 0 ? 0 - static_cast<u32>(q.v) : q.v;
+                return printFixed( q.v < 0, u >> 16, u bitand 0xFFFF, 16 );
+                }
+                Print&
+print           (const Q32 q)
+                {
+                u64 u = q.v < 0 ? 0 - static_cast<u64>(q.v) : q.v;
+                return printFixed( q.v < 0, static_cast<u32>(u >> 32), static_cast<u32>(u), 32 );
+                }
+
                 //reset all options to default (except newline), clear count
                 Print&
 print           (FMT_RESET)
@@ -202,7 +349,9 @@ print           (FMT_RESET)
 
                 //all other printing overloaded print functions
                 Print& print     (const i32 n)       { u32 nu = n; if( n < 0 ){ isNeg_ = true; nu = -nu; } return print( nu ); }
-                Print& print     (const int n)       { u32 nu = n; if( n < 0 ){ isNeg_ = true; nu = -nu; } return print( nu ); }
+                //int is not an i32 for arm-none-eabi (i32 is a long), but is for a host build
+                template<typename T> requires std::is_same_v<T,int> and (not std::is_same_v<int,i32>)
+                Print& print     (const T n)         { return print( static_cast<i32>(n) ); }
                 Print& print     (const u16 n)       { return print( static_cast<u32>(n) ); }
                 Print& print     (const i16 n)       { return print( static_cast<i32>(n) ); }
                 Print& print     (const u8 n)        { return print( static_cast<u32>(n) ); }
@@ -210,10 +359,7 @@ print           (FMT_RESET)
                 Print& print     (const char c)      { write_( c ); return *this; } //direct output, no conversion
                 Print& print     (const bool tf)     { return alpha_ ? print( tf ? "true" : "false" ) : print( tf ? '1' : '0'); }
 
-                //64bit support- only prints if can be expressed as a 32bit value
-                Print& print     (const u64 n)       { return n <= std::numeric_limits<u32>::max() ? print( static_cast<u32>(n) ) : *this; }
-                Print& print     (const i64 n)       { return n <= std::numeric_limits<i32>::max() and 
-                                                              n >= std::numeric_limits<i32>::min() ? print( static_cast<i32>(n) ) : *this; }
+                Print& print     (const i64 n)       { u64 nu = n; if( n < 0 ){ isNeg_ = true; nu = -nu; } return print( nu ); }
 
                 //non-printing overloaded print functions deduced via enum
                 Print& print     (FMT_BASE e)        { base_ = e; return *this;}
@@ -238,14 +384,29 @@ print           (FMT_RESET)
                 int   count     ()                  { return count_; }
 
 private:
+                friend struct Formatter; //Format.hpp, uses digits() and write_()
+                friend class TimeStamp;  //uses dec32()
+
                 //a helper write so we can keep a count of chars written (successfully)
                 //(if any write fails as defined by the parent class (returns false), the failure
                 // is only reflected in the count and not used any further)
                 void write_  (const char c)     { if( write(c) ) count_++; }
+                void write_  (const char* s, u32 n) { count_ += write(s, n); }
 
                 virtual
                 bool write  (const char) = 0; //parent class creates this function
 
+                //a span of chars, returns number written- the parent class can override
+                //to handle a span at once (one virtual call, one lock, etc.), otherwise
+                //is written 1 char at a time
+                virtual
+                u32 write   (const char* s, u32 n) 
+                { 
+                u32 count = 0;
+                for( u32 i = 0; i < n; i++ ) if( write(s[i]) ) count++;
+                return count;
+                }
+
                 char            nl_[3]      { '\n', '\0', '\0' };
                 FMT_JUSTIFY     just_       { left };
                 FMT_SHOWBASE    showbase_   { noshowbase };
@@ -449,6 +610,61 @@ ANSI
                 //ansi rgb colors (used by fg,bg)
                 struct Rgb { u8 r; u8 g; u8 b; };
 
+                //24bit color escapes (\033[38;2;r;g;bm) are up to 19 chars, the 256 color
+                //palette escapes (\033[38;5;nm) are up to 11- set true to use the nearest
+                //palette color instead (6x6x6 cube or gray ramp, as xterm)
+                static constexpr auto ANSI_256{ false };
+
+                //nearest 256 color palette index
+                static constexpr u8
+palette256      (Rgb c)
+                {
+                constexpr u8 levels[6]{ 0, 95, 135, 175, 215, 255 };    //cube levels
+                constexpr u8 mids[5]{ 48, 115, 155, 195, 235 };         //between the levels
+                auto cube = [&](u8 v){ u8 i = 0; while( i < 5 and v >= mids[i] ) i++; return i; };
+                auto dist = [](Rgb a, u8 r, u8 g, u8 b){
+                    int dr = a.r - r, dg = a.g - g, db = a.b - b;
+                    return static_cast<u32>(dr*dr + dg*dg + db*db);
+                    };
+                u8 ri = cube(c.r), gi = cube(c.g), bi = cube(c.b);
+                u32 cd = dist( c, levels[ri], levels[gi], levels[bi] );
+                //gray ramp 8,18..238 (232-255), nearest to the average (/3 by multiply, no divide call)
+                u32 avg = ((c.r + c.g + c.b) * 0xAAAB) >> 17;
+                u8 gr = 0;
+                while( gr < 23 and avg >= 8u + gr*10 + 5 ) gr++;
+                u8 gl = 8 + gr*10;
+                if( dist(c, gl, gl, gl) < cd ) return 232 + gr;
+                return 16 + ri*36 + gi*6 + bi;
+                }
+
+                //the escape for a fg (sgr 38) or bg (sgr 48) color, constexpr so a
+                //constant color is created at compile time (fg<WHITE>())
+                struct Escape { char s[20]; u8 n; };
+                static constexpr Escape
+escape          (u8 sgr, Rgb c)
+                {
+                Escape e{};
+                auto put = [&](char ch){ e.s[e.n++] = ch; };
+                auto putn = [&](u8 v){ //0-255, no divide
+                    u8 h = 0, t = 0;
+                    while( v >= 100 ){ v -= 100; h++; }
+                    while( v >= 10 ){ v -= 10; t++; }
+                    if( h ) put( '0'+h );
+                    if( h or t ) put( '0'+t );
+                    put( '0'+v );
+                    };
+                put( '\033' ); put( '[' ); putn( sgr ); put( ';' );
+                if( ANSI_256 ){ put( '5' ); put( ';' ); putn( palette256(c) ); }
+                else { put( '2' ); put( ';' ); putn( c.r ); put( ';' ); putn( c.g ); put( ';' ); putn( c.b ); }
+                put( 'm' );
+                return e;
+                }
+
+                //the escape is written as 1 span (dec is also set, as the previous
+                //version left it set and following output may rely on that)
+                inline Print&
+                operator<< (Print& p, const Escape& e) { return p << dec << std::string_view{ e.s, e.n }; }
+
                 //ansi fg(Rgb) or fg(r,g,b)
                 struct Fg { Rgb rgb; };
                 inline Fg 
@@ -456,7 +672,7 @@ fg              (Rgb s) { return {s}; }
                 inline Fg 
 fg              (u8 r, u8 g, u8 b) { return { Rgb{r,g,b} }; }
                 inline Print& 
-                operator<< (Print& p, Fg s) { return not ANSI_ON ? p : p << "\033[38;2;" << dec << s.rgb.r << ';' << s.rgb.g << ';' << s.rgb.b << 'm'; }
+                operator<< (Print& p, Fg s) { return not ANSI_ON ? p : p << escape( 38, s.rgb ); }
 
                 //ansi bg(Rgb) or bg(r,g,b)
                 struct Bg { Rgb rgb; };
@@ -465,7 +681,22 @@ bg              (Rgb s) { return {s}; }
                 inline Bg 
 bg              (u8 r, u8 g, u8 b) { return { Rgb{r,g,b} }; }
                 inline Print&
-                operator<< (Print& p, Bg s) { return not ANSI_ON ? p : p << "\033[48;2;" << dec << s.rgb.r << ';' << s.rgb.g << ';' << s.rgb.b << 'm'; }
+                operator<< (Print& p, Bg s) { return not ANSI_ON ? p : p << escape( 48, s.rgb ); }
+
+                //ansi fg<Rgb>(), bg<Rgb>() for a constant color- the escape string is
+                //created at compile time
+                //  uart << fg<WHITE>() << "text" << fg<BLUE*1.5>() << "more";
+                template<Rgb C> struct FgC { static constexpr Escape e{ escape(38, C) }; };
+                template<Rgb C> inline FgC<C>
+fg              () { return {}; }
+                template<Rgb C> inline Print&
+                operator<< (Print& p, FgC<C>) { return not ANSI_ON ? p : p << FgC<C>::e; }
+
+                template<Rgb C> struct BgC { static constexpr Escape e{ escape(48, C) }; };
+                template<Rgb C> inline BgC<C>
+bg              () { return {}; }
+                template<Rgb C> inline Print&
+                operator<< (Print& p, BgC<C>) { return not ANSI_ON ? p : p << BgC<C>::e; }
 
                 //ansi cls
                 enum CLS { 
@@ -660,7 +891,9 @@ reset           };
                 static constexpr Rgb 
 operator *      (const Rgb& r, const double v)
                 {
-                return Rgb{ static_cast<u8>(r.r*v), static_cast<u8>(r.g*v), static_cast<u8>(r.b*v) };
+                //limited to 0-255 (BLUE*1.5 would otherwise overflow the u8)
+                auto m = [v](u8 c){ auto d = c*v; return static_cast<u8>(d > 255 ? 255 : d < 0 ? 0 : d); };
+                return Rgb{ m(r.r), m(r.g), m(r.b) };
                 }
 
                 } //namespace ANSI
@@ -708,4 +941,119 @@ operator<<      (FMT::Print& p, std::chrono::time_point<T,D> tp) //{ return p <<
                 inline FMT::Print&   
 operator,       (FMT::Print& p, std::chrono::time_point<T,D> tp){ return p << tp; }
 
-//........................................................................................
\ No newline at end of file
+//........................................................................................
+                //time_point formatter with cached fields, same output as the time_point
+                //operator<< above- the day/hour/min/sec fields are only recomputed (with
+                //64bit divides) when the time is not in the same or next second as the
+                //last time printed, otherwise only the us field is converted (a u32) and
+                //the seconds are incremented in place, the text is in a fixed template
+                //written as 1 span (days up to 99999, so a unix time clock is cached)
+                //  static FMT::TimeStamp ts; //one per output (holds the last time printed)
+                //  uart << ts( now() ) << " text";
+//////////////// FMT::
+namespace
+FMT
+////////////////
+                {
+
+////////////////
+class
+TimeStamp
+////////////////
+                {
+
+                enum { LEN = 21, DAYS_MAX = 99999 }; //template size
+
+                //"    0d00:00:00.000000", written from buf_[1] (width 4 days, as the
+                //time_point operator<<) unless days are 5 digits
+                char    buf_[LEN+1]{ "    0d00:00:00.000000" };
+                i64     secAt_{ -1 };   //us time of the cached second (-1 = none)
+                u32     days_{ 0 }, hours_{ 0 }, mins_{ 0 }, secs_{ 0 };
+
+                //2 digits (0-99) into the template, no divide
+                void
+put2            (u32 i, u32 v)
+                {
+                u32 t = 0;
+                while( v >= 10 ){ v -= 10; t++; }
+                buf_[i] = '0'+t; buf_[i+1] = '0'+v;
+                }
+
+                //days, right justified width 5 (0-DAYS_MAX, checked by the caller)
+                void
+putDays         ()
+                {
+                char* p = Print::dec32( &buf_[5], days_, 1 );
+                while( p > buf_ ) *--p = ' ';
+                }
+
+                void
+putAll          (){ putDays(); put2( 6, hours_ ); put2( 9, mins_ ); put2( 12, secs_ ); }
+
+                //full recompute from a us time
+                void
+split           (i64 us)
+                {
+                auto sec = static_cast<u64>(us) / 1'000'000;
+                secAt_ = static_cast<i64>(sec) * 1'000'000;
+                if( sec / 86400 > DAYS_MAX ){ days_ = DAYS_MAX+1; return; } //template unchanged
+                days_ = sec / 86400;
+                u32 s = sec - static_cast<u64>(days_)*86400;
+                hours_ = s / 3600; s -= hours_*3600;
+                mins_ = s / 60;
+                secs_ = s - mins_*60;
+                putAll();
+                }
+
+                //the next second, carry into the other fields as needed
+                void
+nextSecond      ()
+                {
+                secAt_ += 1'000'000;
+                if( ++secs_ < 60 ){ put2( 12, secs_ ); return; }
+                secs_ = 0;
+                if( ++mins_ == 60 ){
+                    mins_ = 0;
+                    if( ++hours_ == 24 ){ hours_ = 0; days_++; }
+                    }
+                if( days_ <= DAYS_MAX ) putAll(); //else template unchanged
+                }
+
+public:
+
+                struct Value { TimeStamp& ts; i64 us; };
+
+                template<typename T, typename D> Value
+operator()      (std::chrono::time_point<T,D> tp)
+                {
+                return { *this, std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count() };
+                }
+
+                Print&
+print           (Print& p, i64 us)
+                {
+                if( us >= 0 ){
+                    i64 d = us - secAt_;
+                    if( secAt_ < 0 or d < 0 or d >= 2'000'000 ) split( us ); //not the same or next second
+                    else if( d >= 1'000'000 ) nextSecond();
+                    if( days_ <= DAYS_MAX ){
+                        Print::dec32( &buf_[LEN], static_cast<u32>(us - secAt_), 6 );
+                        u32 i = days_ > 9999 ? 0 : 1;
+                        return p << std::string_view{ &buf_[i], LEN - i };
+                        }
+                    secAt_ = -1;
+                    }
+                //out of the template range (negative, or more than DAYS_MAX days), same
+                //output as the time_point operator<<
+                using tp = std::chrono::time_point<std::chrono::steady_clock, std::chrono::microseconds>;
+                return ::operator<<( p, tp(std::chrono::microseconds(us)) ); //(global, not the FMT operator<<)
+                }
+
+                }; //TimeStamp
+
+                inline Print&
+                operator<< (Print& p, TimeStamp::Value v) { return v.ts.print( p, v.us ); }
+
+                } //namespace FMT
+
+//........................................................................................
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Util.hpp"
+#include "Print.hpp"
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+
+//........................................................................................
+
+                // a Print that formats into a buffer created outside this class (no
+                // memory allocation done here), so a message can be built before it is
+                // sent- to get its length, add a checksum/crc or framing, or to send it
+                // as 1 bulk write (uart, dma)
+
+                // output past the end of the buffer is dropped and isTruncated() is set
+                // (the Print count also only counts the chars stored)
+
+                //  std::array<char,64> buf;
+                //  PrintBuffer msg{ buf };
+                //  msg << "value: " << FMT::dec_(6,v) << FMT::endl;
+                //  if( not msg.isTruncated() ) uart << msg.view(); //1 span write
+                //  msg.clear(); //reuse
+
+////////////////
+class
+PrintBuffer     : public FMT::Print
+////////////////
+                {
+
+                char* const     buf_;
+                u32 const       size_;
+                u32             len_{ 0 };
+                bool            isTruncated_{ false };
+
+                bool
+write           (const char c) override
+                {
+                if( len_ >= size_ ){ isTruncated_ = true; return false; }
+                buf_[len_++] = c;
+                return true;
+                }
+
+                u32
+write           (const char* s, u32 n) override
+                {
+                auto free = size_ - len_;
+                if( n > free ){ n = free; isTruncated_ = true; }
+                __builtin_memcpy( &buf_[len_], s, n );
+                len_ += n;
+                return n;
+                }
+
+public:
+
+                template<std::size_t N> //(size_t, also used in host tools)
+PrintBuffer     (std::array<char,N>& buf)
+                : buf_{ buf.data() },
+                  size_{ N }
+                {
+                }
+
+                template<std::size_t N>
+PrintBuffer     (std::array<u8,N>& buf)
+                : buf_{ reinterpret_cast<char*>(buf.data()) },
+                  size_{ N }
+                {
+                }
+
+                //the chars stored
+                std::string_view
+view            () { return { buf_, len_ }; }
+                const u8*
+data            () { return reinterpret_cast<const u8*>(buf_); }
+                auto
+size            () { return len_; }
+                auto
+sizeFree        () { return size_ - len_; }
+                auto
+isTruncated     () { return isTruncated_; }
+
+                //empty the buffer (format state is kept, the Print count is cleared)
+                PrintBuffer&
+clear           ()
+                {
+                len_ = 0;
+                isTruncated_ = false;
+                *this << FMT::countclr;
+                return *this;
+                }
+
+                //write the contents to another Print device as 1 span
+                //(returns false if the buffer was truncated, the part stored is
+                // still written)
+                bool
+sendTo          (FMT::Print& p)
+                {
+                p << view();
+                return not isTruncated_;
+                }
+
+                }; //PrintBuffer
+
+//........................................................................................
@@ -17,7 +17,8 @@
                 known/fixed location to put debug info in when needed (such as exceptions)
 
                 debugramStart[0-7]  exception stack data (r0-r3,r12,lr,pc,xpsr)
-                debugramStart[9-29] free for any use
+                debugramStart[8-25] free for any use
+                debugramStart[26-28] clock epoch checkpoint (ClockEpoch.hpp)
                 debugramEnd[-1]     a fixed key value to detect power up
                 debugramEnd[-2]     reset count (not power on reset)
 
@@ -56,7 +57,8 @@
 
                 using DebugRam = struct {
                     u32 EXCEPTION_STACK[8]; //exception stack data (r0-r3,r12,lr,pc,xpsr)
-                    u32 FREE[21]; //free for any use
+                    u32 FREE[18]; //free for any use
+                    u32 EPOCH[3]; //clock epoch checkpoint (us)- low, high, check
                     u32 RESET_COUNT; //other than power on
                     u32 KEY;
                     };
@@ -2,6 +2,7 @@
 
 #include "Util.hpp"
 #include "System.hpp"
+#include "ClockEpoch.hpp"
 #include <chrono>
 
 
@@ -46,13 +47,30 @@ Systick
                 static inline u32               cyclesPerIrq_;
                 static inline u32               cpuHz_;
                 static inline u32               shift1us_; //bit shift for cycles to 1us
-                
+                static inline u32               checkpointCount_; //irq's until next checkpoint
+
+                //time resumed from after a reset (0 if power on), added to all times
+                static inline const duration_chrono epoch_{ ClockEpoch::resume() };
+
+                //irq's per ClockEpoch checkpoint (irq rate is too fast to do every irq)
+                static constexpr u32 CHECKPOINT_IRQS_{ 1024 };
+
+                //save the time at the end of the next checkpoint period (the highest
+                //time now() can return before the next checkpoint)
+                static void
+checkpoint      ()
+                {
+                checkpointCount_ = CHECKPOINT_IRQS_;
+                auto cyc = atom_cpuCyclesTotal_ + static_cast<i64>(cyclesPerIrq_) * CHECKPOINT_IRQS_;
+                ClockEpoch::checkpoint( (epoch_ + duration_chrono(cyc * duration_chrono::period::den / cpuHz_)).count() );
+                }
 
                 static auto
 isr             ()
                 {
                 atom_cpuCyclesTotal_ += cyclesPerIrq_;
                 wasIrq_ = true;
+                if( --checkpointCount_ == 0 ) checkpoint();
                 }
 
                 //could be called with irq's disabled, so cannot assume atom_cpuCyclesTotal_ 
@@ -107,6 +125,7 @@ restart         (Nvic::IRQ_PRIORITY priority = DEFAULT_PRIORITY)
                 reg_.RVR = cyclesPerIrq_ - 1;
                 reg_.CVR = 0;
                 reg_.CSR = 7; //processor clock (already set), irq, enable
+                checkpoint();
                 return Systick();
                 }
 
@@ -128,6 +147,7 @@ cycles2chrono   ()
                 //restart() and callback() functions are primarily in mind so only specific
                 //function(s) are allowed to restart systick or set a callback, for example
                 friend int main();
+                friend struct ClockBench; //Benchmark.hpp, times the private functions
 
 public:
 
@@ -145,9 +165,14 @@ public:
 now             ()
                 {
                 onCheck();
-                return time_point( cycles2chrono() ); 
+                return time_point( epoch_ + cycles2chrono() ); 
                 }
 
+                //time the clock resumed from after a software reset, which is where
+                //the time discontinuity is (0 if started from power on)
+                static time_point
+epoch           (){ return time_point( epoch_ ); }
+
                 //TODO-
                 //if irq's are off, delay will never return
 
@@ -172,6 +197,16 @@ wasIrq          ()
                 return ret; 
                 }
 
+                //systick irq wakes the cpu every duration_irq, so there is no wakeup to set
+                //and a wakeup can be up to 1 irq period early (a task scheduler can busy-wait
+                //a low jitter task that is due within this duration)
+                static duration
+wakeupLatency   (){ return std::chrono::duration_cast<duration>( duration_irq(1) ); }
+
+                //same interface as Lptim1ClockLSI, nothing to set (returns t as-is)
+                static time_point
+nextWakeup      (time_point t, bool early = false){ (void)early; return t; }
+
                 }; //Systick
 
 //........................................................................................
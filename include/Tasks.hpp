@@ -24,9 +24,14 @@ public:
                     time_point  runat;      //next run time
                     taskFunc_t  func;       //function to call
                     duration    interval;   //interval
+                    bool        lowJitter;  //busy-wait the last part of the wait to runat
+                    bool        waiting;    //not run until notified (see wait/notify)
+                    bool        notified;   //notify came before wait
                     };
 private:
                 static inline Task tasks_[N]{};
+                static inline bool nextIsLowJitter_;
+                static inline volatile bool wasNotified_;
 
                 static inline auto now = Clock::now;
 
@@ -41,10 +46,18 @@ private:
                 static auto
 run             (Task& t, bool force = false)
                 {
-                if( not t.func ) return;
+                if( not t.func or t.waiting ) return;
                 auto tp = now(); //time_point
-                if( not force and (t.runat > tp) ) return;
+                bool early = t.runat > tp;
+                if( early and not force ){
+                    //a low jitter task due within the clock wakeup latency (the clock
+                    //woke us early for it) is busy-waited to its runat time
+                    if( not t.lowJitter or (t.runat - tp) > Clock::wakeupLatency() ) return;
+                    while( tp = now(), t.runat > tp ){}
+                    early = false;
+                    }
                 if( not t.func( t ) ) return; //returned false, keep same runat time
+                if( early ) return; //forced before its runat (an event), schedule unchanged
                 // if( t.interval.count() > 0 ) t.runat = tp + t.interval;
 if( t.interval.count() > 0 ) t.runat += t.interval; //based on previous runat time
                 else if( t.runat <= tp ) t.func = 0; //remove( t.func );
@@ -56,7 +69,8 @@ public:
                 static u32 
 id              (Task& t) { return reinterpret_cast<u32>(t.func); }
 
-                //run a single task (if in the task list)
+                //run a single task now (if in the task list), like on an event- if not
+                //due yet, its runat is not changed
                 static void
 run             (taskFunc_t f){ for(auto& t : tasks_) if(t.func == f) run(t, true); } //true = force
 
@@ -74,13 +88,60 @@ run             ()
                 //init a 'next' time far in future so we can find the soonest next task
                 //(and if no tasks in next 24hours, will run in 24hours anyway)
                 time_point next{ now() + std::chrono::hours(24) };
+                nextIsLowJitter_ = false;
                 for( auto& t : tasks_ ){
-                    if( not t.func ) continue;
-                    if( t.runat < next ) next = t.runat; //find soonest next runat time
+                    if( not t.func or t.waiting ) continue; //(a waiting task has no run time)
+                    if( t.runat >= next ) continue;
+                    next = t.runat; //find soonest next runat time
+                    nextIsLowJitter_ = t.lowJitter;
                     }
                 return next; //return next time we need to run
                 }
 
+                //a task waiting for an event (like an Ownership grant) instead of returning
+                //false and being run again at every wakeup-
+                //      if( not device ) return tasks.wait( task ); //false, runat kept
+                //the task is skipped until notify(id) (from any irq level, the event
+                //source calls it), then runs at the next run()
+                //(if the notify already came, the task is not put to waiting)
+                static bool
+wait            (Task& t)
+                {
+                InterruptLock lock;
+                if( t.notified ) t.notified = false;
+                else t.waiting = true;
+                return false;
+                }
+
+                static void
+notify          (u32 id)
+                {
+                InterruptLock lock;
+                for( auto& t : tasks_ ){
+                    if( not t.func or id != Tasks::id(t) ) continue;
+                    if( t.waiting ) t.waiting = false;
+                    else t.notified = true;
+                    wasNotified_ = true;
+                    return;
+                    }
+                }
+
+                //a notify happened since the last call (so the sleep loop can return to
+                //run() instead of waiting for the next task time)
+                static bool
+wasNotified     ()
+                {
+                InterruptLock lock;
+                bool n = wasNotified_;
+                wasNotified_ = false;
+                return n;
+                }
+
+                //if the task due at the time returned by run() is a low jitter task
+                //(so the clock wakeup can be set early, see Clock::nextWakeup)
+                static bool
+nextIsLowJitter (){ return nextIsLowJitter_; }
+
 
                 static auto
 remove          (taskFunc_t f)
@@ -96,8 +157,11 @@ remove          (taskFunc_t f)
                 //if interval is 0- task runs right away and
                 //will only run 1 time unless task sets interval or runat
                 //if interval is not 0 the task next runs at now()+interval
+                //lowJitter = true- the clock wakes early (by its average wakeup latency)
+                //and the last part of the wait is a busy-wait, so the task runs close to 
+                //its runat time (other tasks keep the pure sleep wait)
                 static auto
-insert          (taskFunc_t f, duration interval = std::chrono::milliseconds(0))
+insert          (taskFunc_t f, duration interval = std::chrono::milliseconds(0), bool lowJitter = false)
                 {
                 remove( f ); //so we do not get multiple instances of function in tasks_
                 for( auto& t : tasks_ ){
@@ -105,6 +169,9 @@ insert          (taskFunc_t f, duration interval = std::chrono::milliseconds(0))
                     t.func = f;
                     t.interval = interval;
                     t.runat = now() + interval;
+                    t.lowJitter = lowJitter;
+                    t.waiting = false;
+                    t.notified = false;
                     return true;
                     }
                 return false;
@@ -113,10 +180,10 @@ insert          (taskFunc_t f, duration interval = std::chrono::milliseconds(0))
                 //run at a time_point time ( not a 'now' based time )
                 //will only run 1 time unless task sets interval or runat
                 static auto
-insert          (taskFunc_t f, time_point tp)
+insert          (taskFunc_t f, time_point tp, bool lowJitter = false)
                 {
                 auto from_now = tp - now(); //convert to now based time
-                return insert(f, from_now); //so can resuse the above insert
+                return insert(f, from_now, lowJitter); //so can resuse the above insert
                 }
 
                 }; //Tasks
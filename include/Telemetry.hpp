@@ -0,0 +1,170 @@
+#pragma once
+
+#include "Util.hpp"
+#include "Crc.hpp"
+#include <array>
+#include <chrono>
+#include <string_view>
+#include <type_traits>
+
+
+//........................................................................................
+
+                // binary telemetry frames, in place of formatted text- a record is a
+                // type id (user chosen) and typed fields, framed so the pc side decoder
+                // (tools/teldecode.cpp) can find each frame in the stream and check it
+
+                // frame (before cobs)- type seq fields... crc16(hi,lo)
+                //  seq     u8, +1 per frame (the decoder reports missing frames)
+                //  field   code + varint value (little endian 7bits per byte)-
+                //      'u' unsigned integer/bool
+                //      'i' signed integer (zigzag, so small negative values are short)
+                //      'T' std::chrono time_point, us since epoch (zigzag)
+                //      'D' std::chrono duration, us (zigzag)
+                //  crc16   Crc16 of type..fields
+                // the frame is cobs encoded (no 0 bytes) between 0 bytes, so the decoder
+                // resyncs at the next 0 after any error, and normal text output (no 0
+                // bytes) in the same stream is seen as not a frame and passed through
+
+                // record() returns the frame to send as 1 span (uart, UartMux)-
+                //  static Telemetry tel;
+                //  if( not board.uartMux.fits(Telemetry::frameMax(3)) ) return false;
+                //  board.uartMux.send( tel.record(1, now(), tdly, n) );
+
+                // also used by the host decoder (Telemetry::decode), so no mcu headers
+
+////////////////
+class
+Telemetry
+////////////////
+                {
+
+public:
+                enum { FIELDS_MAX = 16, RAW_MAX = 2 + FIELDS_MAX*11 + 2, FRAME_MAX = RAW_MAX + RAW_MAX/254 + 3 };
+
+private:
+                u8                          seq_{ 0 };
+                std::array<u8,FRAME_MAX>    frame_;
+
+                static void
+varint          (u8*& p, u64 v)
+                {
+                while( v >= 0x80 ){ *p++ = v bitor 0x80; v >>= 7; }
+                *p++ = v;
+                }
+
+                static u64
+zigzag          (i64 v){ return (static_cast<u64>(v) << 1) ^ static_cast<u64>(v >> 63); }
+
+                //field -> code + varint
+                template<typename T> static void
+put             (u8*& p, const T& v)
+                {
+                using namespace std::chrono;
+                if constexpr( std::is_same_v<T,bool> ){ *p++ = 'u'; varint( p, v ); }
+                else if constexpr( std::is_integral_v<T> and std::is_unsigned_v<T> ){ *p++ = 'u'; varint( p, v ); }
+                else if constexpr( std::is_integral_v<T> ){ *p++ = 'i'; varint( p, zigzag(v) ); }
+                else if constexpr( requires(T t){ duration_cast<microseconds>(t.time_since_epoch()); } ){
+                    *p++ = 'T'; varint( p, zigzag(duration_cast<microseconds>(v.time_since_epoch()).count()) );
+                    }
+                else if constexpr( requires(T t){ duration_cast<microseconds>(t); } ){
+                    *p++ = 'D'; varint( p, zigzag(duration_cast<microseconds>(v).count()) );
+                    }
+                else static_assert( sizeof(T) == 0, "Telemetry: unsupported field type" );
+                }
+
+public:
+
+                //cobs encode n bytes (no 0 bytes in the output), returns output size
+                //(out needs n + n/254 + 1 bytes)
+                static u32
+cobs            (const u8* in, u32 n, u8* out)
+                {
+                u32 ci = 0, o = 1; //code index, output index
+                u8 code = 1;
+                for( u32 i = 0; i < n; i++ ){
+                    if( in[i] ){
+                        out[o++] = in[i];
+                        if( ++code < 0xFF ) continue;
+                        }
+                    out[ci] = code; //0 byte, or a full 254 byte block
+                    ci = o++;
+                    code = 1;
+                    }
+                out[ci] = code;
+                return o;
+                }
+
+                //cobs decode (frame without its 0 end byte), returns output size, 0 if
+                //not valid (out needs n bytes)
+                static u32
+uncobs          (const u8* in, u32 n, u8* out)
+                {
+                u32 i = 0, o = 0;
+                while( i < n ){
+                    u8 code = in[i++];
+                    if( code == 0 or i + code - 1 > n ) return 0;
+                    for( u8 k = 1; k < code; k++ ) out[o++] = in[i++];
+                    if( code < 0xFF and i < n ) out[o++] = 0;
+                    }
+                return o;
+                }
+
+                //largest frame for a record with n fields, the room to check for before
+                //record() (a refused frame would use up a sequence number, and show as
+                //lost in the decoder)
+                static constexpr u32
+frameMax        (u32 fields){ u32 raw = 2 + fields*11 + 2; return raw + raw/254 + 3; }
+
+                //a record -> frame, returns the frame (valid until the next record)
+                template<typename... Ts> std::string_view
+record          (u8 type, const Ts&... fields)
+                {
+                static_assert( sizeof...(Ts) <= FIELDS_MAX, "Telemetry: too many fields" );
+                u8 raw[RAW_MAX];
+                auto p = raw;
+                *p++ = type;
+                *p++ = seq_++;
+                ( put( p, fields ), ... );
+                u16 crc = Crc16::calc( raw, p - raw );
+                *p++ = crc >> 8;
+                *p++ = crc;
+                frame_[0] = 0; //end of any text before
+                u32 n = 1 + cobs( raw, p - raw, &frame_[1] );
+                frame_[n++] = 0; //end of frame
+                return { reinterpret_cast<const char*>(frame_.data()), n };
+                }
+
+                //decoded frame (host decoder)- raw frame bytes (type seq fields...),
+                //false if the cobs or crc check fails
+                static bool
+decode          (const u8* in, u32 n, u8* raw, u32& rawLen)
+                {
+                rawLen = uncobs( in, n, raw );
+                if( rawLen < 4 ) return false;
+                u16 crc = raw[rawLen-2] << 8 bitor raw[rawLen-1];
+                rawLen -= 2;
+                return Crc16::calc( raw, rawLen ) == crc;
+                }
+
+                //next field of a decoded frame (host decoder), false if no more (or bad)
+                //(i = index into raw, starts at 2 after type/seq)
+                static bool
+field           (const u8* raw, u32 rawLen, u32& i, char& code, i64& v)
+                {
+                if( i >= rawLen ) return false;
+                code = raw[i++];
+                u64 u = 0;
+                for( u32 sh = 0; ; sh += 7 ){
+                    if( i >= rawLen or sh > 63 ) return false;
+                    u8 b = raw[i++];
+                    u or_eq static_cast<u64>(b bitand 0x7F) << sh;
+                    if( not (b bitand 0x80) ) break;
+                    }
+                v = code == 'u' ? static_cast<i64>(u) : static_cast<i64>(u >> 1) ^ -static_cast<i64>(u bitand 1);
+                return code == 'u' or code == 'i' or code == 'T' or code == 'D';
+                }
+
+                }; //Telemetry
+
+//........................................................................................
@@ -5,7 +5,8 @@
 #include "GpioPin.hpp"
 #include "System.hpp"
 #include <array>
-#include "BufferBytes.hpp"
+#include "BufferBytesSpsc.hpp"
+#include "Dma.hpp"
 #include MY_MCU_HEADER
 
 
@@ -25,35 +26,190 @@ Uart
                              TDR, PRESC; };
                 
                 volatile Reg&       reg_; //need volatile as Reg struct members are not
-                BufferBytes         buffer_;
+                //single producer/single consumer buffers (tx- task writes, isr reads,
+                //rx- isr writes, task reads), so no lock needed for the buffer access
+                BufferBytesSpsc     buffer_;
+                BufferBytesSpsc     rxBuffer_; //size 0 if rx not used
                 Nvic::IRQ_PRIORITY  irqPriorty_;
                 MCU::IRQn           irqn_;
                 u32                 baud_;
+                DmaChannel          txDma_;         //not used if no channel given
+                u32                 txDmaLen_{ 0 }; //bytes in the current dma transfer (0 = idle)
 
-                enum { TEbm = 1<<3, UEbm = 1, TXEbm = 1<<7, TCbm = 1<<6 };
+                //rx dma- the rx buffer array is a circular dma buffer, the dma write
+                //position is read at each rx event (idle, timeout, half/full transfer)
+                //and added to rxTotal_, the reader reads in place from rxRdIdx_
+                DmaChannel          rxDma_;
+                u8*                 rxBuf_{ nullptr };
+                u32                 rxSize_{ 0 };
+                u32                 rxPos_{ 0 };        //dma write index at the last rx event
+                u32                 rxRdIdx_{ 0 };      //read index
+                u32                 rxTotal_{ 0 };      //bytes received, free running
+                u32                 rxRdTotal_{ 0 };    //bytes read, free running
+                u32                 rxLost_{ 0 };       //bytes overwritten before read
+                volatile bool       rxEvent_{ false };  //line idle/timeout seen (rx burst done)
 
+                bool const          hasFifo_;
+                bool                fifo_{ false };     //fifo mode on (see fifoMode)
+
+public:
+                //what a write does when the tx buffer is full (see overflowPolicy)
+                enum OVERFLOW_POLICY { BLOCK, DROP_NEWEST, DROP_OLDEST, TRUNCATE };
+                static constexpr u8 TRUNCATE_MARK{ '~' };
+                //tx events (see onTxEvent)
+                enum TX_EVENT { TX_COMPLETE = 1, TX_LOWWATER = 2, TX_EMPTY = 4 };
+                using txEvent_t = void(*)(TX_EVENT);
+private:
+                OVERFLOW_POLICY     policy_{ BLOCK };
+                bool                overflow_{ false };     //rest of the line is dropped
+                u32                 droppedBytes_{ 0 };
+                u32                 droppedMsgs_{ 0 };      //lines/messages with bytes dropped
+
+                txEvent_t           txEvent_{ nullptr };
+                u8                  txEvents_{ 0 };         //TX_EVENT bits wanted
+                u32                 txLowWater_{ 0 };
+
+                enum { TEbm = 1<<3, UEbm = 1, TXEbm = 1<<7, TCbm = 1<<6, TCIEbm = 1<<6,
+                       REbm = 1<<2, RXNEbm = 1<<5, RXNEIEbm = 1<<5, OREbm = 1<<3,
+                       DMATbm = 1<<7, DMARbm = 1<<6,
+                       IDLEbm = 1<<4, IDLEIEbm = 1<<4, RTOFbm = 1<<11, RTOIEbm = 1<<26, RTOENbm = 1<<23,
+                       FIFOENbm = 1<<29, TXFTIEbm = 1<<23, RXFTIEbm = 1<<28, TXFTCFGbp = 29, RXFTCFGbp = 25 };
+
+                //in fifo mode TXE/RXNE are TXFNF/RXFNE (fifo not full/not empty, same bits),
+                //the tx irq is the tx fifo threshold irq instead of TXFNF (so 1 irq per
+                //threshold worth of bytes instead of 1 per byte)
+                auto
+txeIrqReg       () { return fifo_ ? &reg_.CR3 : &reg_.CR1; }
+                u32
+txeIrqBm        () { return fifo_ ? TXFTIEbm : TXEbm; }
                 auto
-txeIrqOn        () { reg_.CR1 = reg_.CR1 bitor TXEbm; }
+txeIrqOn        () { auto r = txeIrqReg(); *r = *r bitor txeIrqBm(); }
                 auto
-txeIrqOff       () { reg_.CR1 = reg_.CR1 bitand compl TXEbm; }
+txeIrqOff       () { auto r = txeIrqReg(); *r = *r bitand compl txeIrqBm(); }
                 auto
-txeIrqIsOff     () { return not (reg_.CR1 bitand TXEbm); }
+txeIrqIsOff     () { return not (*txeIrqReg() bitand txeIrqBm()); }
                 auto
 txOn            () { reg_.CR1 = TEbm bitor UEbm; }
                 auto
+rxOn            ()
+                {
+                reg_.ICR = IDLEbm; //(IDLECF same bit position)
+                if( not rxDma_.isUsed() ){ reg_.CR1 = reg_.CR1 bitor REbm bitor RXNEIEbm bitor IDLEIEbm; return; }
+                //rx dma, circular into the rx buffer, irq at half and full so the
+                //position is seen at least twice per lap (so an overrun can be counted)
+                rxDma_.start( &reg_.RDR, rxBuf_, rxSize_,
+                              DmaChannel::PERIPH2MEM bitor DmaChannel::CIRC bitor DmaChannel::HTIE bitor DmaChannel::TCIE );
+                reg_.CR3 = reg_.CR3 bitor DMARbm;
+                Nvic::setFunction( rxDma_.irqn(), this, irqPriorty_ );
+                reg_.CR1 = reg_.CR1 bitor REbm bitor IDLEIEbm;
+                }
+                auto
 isTxFull        (){ return (reg_.ISR bitand TXEbm) == 0; }
                 auto 
 isTxComplete    (){ return reg_.ISR bitand TCbm; }
+                //(fifo mode- fill the tx fifo, empty the rx fifo)
+                //tx events, from the isr (or a waitRoom that does the isr work)
+                void
+txEvent         (TX_EVENT e){ if( txEvents_ bitand e ) txEvent_( e ); }
+
+                //n bytes were taken from the buffer, low water if used went below it
+                void
+txTaken         (u32 n)
+                {
+                if( not (txEvents_ bitand TX_LOWWATER) ) return;
+                auto u = buffer_.sizeUsed();
+                if( u < txLowWater_ and u + n >= txLowWater_ ) txEvent( TX_LOWWATER );
+                }
+
+                //buffer empty, the last bytes are still in the hardware- the tc irq
+                //gives the complete event (tc is left set, isIdle uses it)
+                void
+txEmpty         ()
+                {
+                if( txEvents_ bitand TX_COMPLETE ) reg_.CR1 = reg_.CR1 bitor TCIEbm;
+                txEvent( TX_EMPTY );
+                }
+
                 auto
 bufferTx        ()
                 {
                 u8 v = 0;
-                if( buffer_.read(v) ) reg_.TDR = v;
-                else txeIrqOff();
+                do{
+                    if( not buffer_.read(v) ){ txeIrqOff(); return txEmpty(); }
+                    reg_.TDR = v;
+                    txTaken( 1 );
+                    } while( fifo_ and not isTxFull() );
                 }
 
-                bool
-writeBuffer     (const char c)
+                //uart hardware -> rx buffer (if rx buffer is full, the byte is lost)
+                auto
+bufferRx        ()
+                {
+                reg_.ICR = OREbm; //clear any overrun (ORECF same bit position)
+                do{ rxBuffer_.write( reg_.RDR ); } while( fifo_ and (reg_.ISR bitand RXNEbm) );
+                }
+
+                //dma tx- start the next contiguous run of the buffer, at most half the
+                //buffer so the other half can be filled while this run is sent (the
+                //bytes stay in the buffer until the transfer completes)
+                //(called with irq's off or from the isr)
+                void
+txDmaNext       ()
+                {
+                u32 n;
+                auto p = buffer_.peek( n );
+                auto nmax = buffer_.size()/2;
+                if( n > nmax ) n = nmax;
+                txDmaLen_ = n;
+                if( n ) txDma_.start( &reg_.TDR, p, n, DmaChannel::MEM2PERIPH bitor DmaChannel::TCIE bitor DmaChannel::TEIE );
+                }
+
+                //transfer complete (or error), free the bytes sent, start the next run
+                void
+txDmaDone       ()
+                {
+                txDma_.clear();
+                buffer_.consume( txDmaLen_ );
+                txTaken( txDmaLen_ );
+                txDmaNext();
+                if( txDmaLen_ == 0 ) txEmpty();
+                }
+
+                //new data in the buffer, start tx if not already running
+                //(txe irq on needs no lock- if the isr turns it off in between, it saw
+                //an empty buffer before this write and the irq just runs again, the
+                //dma start does need it as the isr also starts the next run)
+                void
+txStart         ()
+                {
+                if( not txDma_.isUsed() ) return txeIrqOn();
+                InterruptLock lock;
+                if( txDmaLen_ == 0 ) txDmaNext();
+                }
+
+                //rx dma event, bytes received since the last event -> rxTotal_
+                //(if more than the buffer size is unread, the oldest were overwritten-
+                //the reader is moved to the oldest byte still in the buffer)
+                //(called with irq's off or from the isr)
+                void
+rxDmaUpdate     ()
+                {
+                u32 pos = rxSize_ - rxDma_.remaining(); //CNDTR reloads to rxSize_ at the end
+                if( pos >= rxSize_ ) pos = 0;
+                u32 n = pos >= rxPos_ ? pos - rxPos_ : pos + rxSize_ - rxPos_;
+                rxPos_ = pos;
+                rxTotal_ += n;
+                u32 unread = rxTotal_ - rxRdTotal_;
+                if( unread > rxSize_ ){
+                    rxLost_ += unread - rxSize_;
+                    rxRdTotal_ = rxTotal_ - rxSize_;
+                    rxRdIdx_ = pos;
+                    }
+                }
+
+                //wait for room in the buffer for at least 1 byte
+                auto
+waitRoom        ()
                 {
                 //if buffer full and this irq level <= uart irq level
                 //we have to take care of the isr duties ourselves since the
@@ -61,24 +217,131 @@ writeBuffer     (const char c)
                 while( buffer_.isFull() ){
                     if( Nvic::activePriority() > irqPriorty_ ) continue; //let isr handle it
                     //isr cannot help
+                    if( txDma_.isUsed() ){ //wait for the dma transfer
+                        while( not (txDma_.flags() bitand (DmaChannel::TCIF bitor DmaChannel::TEIF)) ){}
+                        InterruptLock lock;
+                        txDmaDone();
+                        Nvic::clearPending( txDma_.irqn() );
+                        break;
+                        }
                     while( isTxFull() ){} //first wait for hardware
                     bufferTx();
                     Nvic::clearPending( irqn_ ); //clear irq pending
                     break;
                     } //now buffer has room for at least 1 byte...
+                }
+
+                //unsent bytes that drop-oldest can drop- with tx dma, not the run being
+                //sent (the isr is the reader, so with irq's off)
+                u32
+droppable       (){ return buffer_.sizeUsed() - txDmaLen_; }
+
+                //drop-oldest, free at least n bytes of the unsent bytes (the caller
+                //checked they are droppable)- from the read side of the buffer, or with
+                //tx dma (the oldest bytes are in the run being sent) all the bytes queued
+                //behind that run (they are older than the write that needs the room),
+                //returns bytes freed
+                u32
+dropOldest      (u32 n)
+                {
+                InterruptLock lock;
+                auto d = droppable();
+                if( n > d ) n = d;
+                if( txDma_.isUsed() ) n = buffer_.unwrite( d );
+                else buffer_.consume( n );
+                if( n ){ droppedBytes_ += n; droppedMsgs_++; }
+                return n;
+                }
 
-                //protect write+irq enable combo (so uart isr cannot disable txeIrq inside
-                //this sequence)
-                InterruptLock lock; 
+                //non-blocking write (policy not BLOCK), what does not fit is dropped
+                //per line- once a span does not fit, the rest of its line is dropped up
+                //to the newline (which is kept if there is room, so the next line starts
+                //clean), returns bytes written
+                u32
+writeNoBlock    (const u8* p, u32 n)
+                {
+                if( n == 0 ) return 0;
+                if( overflow_ ){ //rest of a line that overflowed
+                    u32 i = 0;
+                    while( i < n and p[i] != '\n' ) i++;
+                    droppedBytes_ += i;
+                    if( i == n ) return 0;
+                    overflow_ = false;
+                    p += i; n -= i;
+                    }
+                u32 nl = p[n-1] == '\n'; //span ends the line (1 byte to keep)
+                u32 free = buffer_.sizeFree();
+                if( n > free and policy_ == DROP_OLDEST ){
+                    InterruptLock lock;
+                    if( n <= free + droppable() ) free += dropOldest( n - free );
+                    }
+                u32 k = n;
+                if( n > free ){ //overflow
+                    k = 0;
+                    //truncate- as much as fits and a marker (and the newline)
+                    if( policy_ == TRUNCATE and free > nl ){
+                        k = free - 1 - nl;
+                        buffer_.write( p, k );
+                        buffer_.write( TRUNCATE_MARK );
+                        }
+                    droppedBytes_ += n - k;
+                    droppedMsgs_++;
+                    if( nl and buffer_.write('\n') ) droppedBytes_--;
+                    overflow_ = not nl;
+                    }
+                else buffer_.write( p, n );
+                if( not buffer_.isEmpty() ) txStart();
+                return k;
+                }
+
+                bool
+writeBuffer     (const char c)
+                {
+                if( policy_ != BLOCK ) return writeNoBlock( reinterpret_cast<const u8*>(&c), 1 );
+                waitRoom();
                 buffer_.write( c );
-                txeIrqOn();
+                txStart();
                 return true;
                 }
 
-                // buffer -> uart hardware
+                //span, copied in as much as fits (repeats if the buffer fills)
+                u32
+writeBuffer     (const u8* p, u32 n)
+                {
+                if( policy_ != BLOCK ) return writeNoBlock( p, n );
+                for( u32 i = 0; i < n; ){
+                    waitRoom();
+                    i += buffer_.write( &p[i], n - i );
+                    txStart();
+                    }
+                return n;
+                }
+
+                // buffer -> uart hardware, uart hardware -> rx buffer
+                // (also the isr for the tx/rx dma channel irq's)
                 void
 isr             () override 
-                { bufferTx(); }
+                { 
+                auto flags = reg_.ISR;
+                if( rxDma_.isUsed() ){
+                    if( flags bitand OREbm ) reg_.ICR = OREbm;
+                    if( rxDma_.flags() ){ rxDma_.clear(); rxDmaUpdate(); }
+                    }
+                else if( flags bitand (RXNEbm bitor OREbm) ) bufferRx();
+                //line idle or receiver timeout, the end of a burst
+                if( flags bitand (IDLEbm bitor RTOFbm) ){
+                    reg_.ICR = flags bitand (IDLEbm bitor RTOFbm); //(IDLECF,RTOCF same bit positions)
+                    if( rxDma_.isUsed() ) rxDmaUpdate();
+                    rxEvent_ = true;
+                    }
+                if( (flags bitand TXEbm) and not txeIrqIsOff() ) bufferTx();
+                if( txDma_.isUsed() and (txDma_.flags() bitand (DmaChannel::TCIF bitor DmaChannel::TEIF)) ) txDmaDone();
+                //tx complete (enabled at buffer empty), an event only if still idle
+                if( (flags bitand TCbm) and (reg_.CR1 bitand TCIEbm) ){
+                    reg_.CR1 = reg_.CR1 bitand compl TCIEbm;
+                    if( isIdle() ) txEvent( TX_COMPLETE );
+                    }
+                }
 
                 auto
 baud            ()
@@ -90,43 +353,230 @@ baud            ()
                 reg_.BRR = v; 
                 }
 
+                //called by constructors
+                auto
+init            (MCU::uart_t u)
+                {
+                { InterruptLock lock; u.init(); } //rcc
+                GpioPin(u.txPin).alternate( u.txAltFunc );
+                baud();
+                Nvic::setFunction( irqn_, this, irqPriorty_ );
+                txOn();
+                if( txDma_.isUsed() ){ //tx dma, transfer complete irq instead of txe
+                    reg_.CR3 = reg_.CR3 bitor DMATbm;
+                    Nvic::setFunction( txDma_.irqn(), this, irqPriorty_ );
+                    }
+                }
+
 public:
 
                 auto
 cpuSpeedUpdate  (){ baud(); }
 
-                auto
-isIdle          (){ return txeIrqIsOff() and isTxComplete(); }
+                bool
+isIdle          (){ return (txDma_.isUsed() ? txDmaLen_ == 0 : txeIrqIsOff()) and isTxComplete(); }
 
                 virtual bool
 write           (const char c){ return writeBuffer(c); }
 
+                virtual u32
+write           (const char* s, u32 n){ return writeBuffer( reinterpret_cast<const u8*>(s), n ); }
+
+                //a whole message (1 span, see UartMux), the overflow policy applies to
+                //all of it (not BLOCK- nothing is written if it does not fit, or what
+                //fits and TRUNCATE_MARK), returns bytes written
+                u32
+writeMessage    (const char* s, u32 n)
+                {
+                if( policy_ == BLOCK ) return write( s, n );
+                overflow_ = false; //not part of a Print line
+                auto k = writeNoBlock( reinterpret_cast<const u8*>(s), n );
+                overflow_ = false;
+                return k;
+                }
+
                 //binary array of data
                 template<unsigned N> bool
 write           (std::array<u8,N>& arr)
                 { 
-                for( auto c : arr ) writeBuffer(c); 
+                writeBuffer( arr.data(), N ); 
+                return true;
+                }
+
+                //received bytes in place (no copy), contiguous from the read position,
+                //n = 0 if none- free them with readDone(n) (a span can have more
+                //bytes after it, so repeat until n = 0)
+                //with rx dma the bytes are seen at each rx event (line idle, or each half
+                //of the buffer in a long burst), and are overwritten if not read before
+                //another rx buffer size of bytes is received (see rxLost)
+                const u8*
+readSpan        (u32& n)
+                {
+                if( not rxDma_.isUsed() ) return rxBuffer_.peek( n );
+                InterruptLock lock;
+                n = rxTotal_ - rxRdTotal_;
+                auto n1 = rxSize_ - rxRdIdx_;
+                if( n > n1 ) n = n1;
+                return &rxBuf_[rxRdIdx_];
+                }
+
+                void
+readDone        (u32 n)
+                {
+                if( not rxDma_.isUsed() ) return rxBuffer_.consume( n );
+                InterruptLock lock;
+                auto unread = rxTotal_ - rxRdTotal_; //(less than n if overwritten meanwhile)
+                if( n > unread ) n = unread;
+                rxRdIdx_ += n;
+                if( rxRdIdx_ >= rxSize_ ) rxRdIdx_ -= rxSize_;
+                rxRdTotal_ += n;
+                }
+
+                //read a received byte, false if none available
+                bool
+read            (u8& c)
+                {
+                if( not rxDma_.isUsed() ) return rxBuffer_.read(c);
+                u32 n;
+                auto p = readSpan( n );
+                if( n == 0 ) return false;
+                c = *p;
+                readDone( 1 );
+                return true;
+                }
+
+                //true if the rx line went idle (or receiver timeout) since the last call,
+                //so a task can be run when a burst ends instead of polling
+                bool
+rxEvent         ()
+                {
+                InterruptLock lock;
+                bool e = rxEvent_;
+                rxEvent_ = false;
+                return e;
+                }
+
+                //bytes lost to an rx dma buffer overrun
+                auto
+rxLost          (){ return rxLost_; }
+
+                //receiver timeout in bit times (also ends a burst, after a longer gap than
+                //idle)- USART1 only on the G031 (USART2 has no receiver timeout)
+                auto
+rxTimeout       (u32 bits)
+                {
+                reg_.RTOR = bits bitand 0xFFFFFF;
+                reg_.CR2 = reg_.CR2 bitor RTOENbm; //(can be written with UE set)
+                reg_.CR1 = reg_.CR1 bitor RTOIEbm;
+                }
+
+                //tx buffer full policy, per line for the Print writes and per message
+                //for writeMessage (UartMux)-
+                //  BLOCK       wait for room (default), a write never loses bytes, but
+                //              the caller is stuck until the uart makes room
+                //  DROP_NEWEST the line/message is dropped from where it does not fit
+                //  DROP_OLDEST the oldest unsent bytes are dropped to make room (with tx
+                //              dma, the bytes queued behind the run being sent), if that
+                //              is not enough, same as DROP_NEWEST
+                //  TRUNCATE    as much as fits followed by TRUNCATE_MARK
+                //the non-blocking policies never wait, so a task cannot stall the others
+                //by printing too much (see droppedBytes/droppedMsgs)
+                auto
+overflowPolicy  (OVERFLOW_POLICY p){ policy_ = p; overflow_ = false; }
+                auto
+overflowPolicy  (){ return policy_; }
+                auto
+droppedBytes    (){ return droppedBytes_; }
+                auto
+droppedMsgs     (){ return droppedMsgs_; }
+
+                enum //fifo threshold, tx- empty locations, rx- bytes received
+FIFO_TH         { FIFO_1_8, FIFO_1_4, FIFO_1_2, FIFO_3_4, FIFO_7_8, FIFO_8_8 };
+
+                //fifo mode (USART1 only on the G031, false if the uart has no fifo)-
+                //the tx irq fires when the tx fifo has txTh empty locations and refills
+                //it (up to 8 bytes per irq), the rx irq (no rx dma) fires when the rx
+                //fifo has rxTh bytes, the rest of a burst is read at line idle
+                //(the uart is disabled while changing, so call before use or when idle)
+                bool
+fifoMode        (FIFO_TH txTh = FIFO_1_2, FIFO_TH rxTh = FIFO_3_4)
+                {
+                if( not hasFifo_ ) return false;
+                while( not isIdle() ){}
+                InterruptLock lock;
+                u32 cr1 = reg_.CR1;
+                reg_.CR1 = 0; //UE off to set FIFOEN
+                u32 cr3 = reg_.CR3 bitand compl (7u<<TXFTCFGbp bitor 7u<<RXFTCFGbp bitor TXFTIEbm bitor RXFTIEbm);
+                cr3 or_eq u32(txTh)<<TXFTCFGbp bitor u32(rxTh)<<RXFTCFGbp;
+                if( cr1 bitand RXNEIEbm ){ cr1 and_eq compl RXNEIEbm; cr3 or_eq RXFTIEbm; } //rx irq -> threshold
+                reg_.CR3 = cr3;
+                reg_.CR1 = cr1 bitor FIFOENbm; //(tx irq is off, idle)
+                fifo_ = true;
                 return true;
                 }
 
+                //tx event callback, called from the uart isr (keep it short)-
+                //  TX_COMPLETE the last byte is out, the uart is idle (isIdle)
+                //  TX_LOWWATER the tx buffer used went below lowWater, so a producer can
+                //              refill in a burst instead of polling for room
+                //  TX_EMPTY    the tx buffer is empty (the last bytes still going out)
+                //events = TX_EVENT bits wanted, f = nullptr for none
+                //      uart.onTxEvent( [](Uart::TX_EVENT e){ ... }, Uart::TX_COMPLETE );
+                auto
+onTxEvent       (txEvent_t f, u8 events, u32 lowWater = 0)
+                {
+                InterruptLock lock;
+                txEvent_ = f;
+                txEvents_ = f ? events : 0;
+                txLowWater_ = lowWater;
+                }
+
                 auto 
 bufferUsedMax   (){ return buffer_.sizeUsedMax(); }
                 auto 
 bufferUsed      (){ return buffer_.sizeUsed(); }
+                auto 
+bufferFree      (){ return buffer_.sizeFree(); }
+                auto 
+bufferSize      (){ return buffer_.size(); }
 
+                //tx only (buffer sizes a power of 2)
+                //optional txDma- a dma channel for tx, the buffer is sent in runs (1 irq
+                //per run instead of 1 per byte)
                 template<unsigned N>
-Uart            (MCU::uart_t u, u32 baudVal, std::array<u8,N>& buffer, Nvic::IRQ_PRIORITY irqPriority)
+Uart            (MCU::uart_t u, u32 baudVal, std::array<u8,N>& buffer, Nvic::IRQ_PRIORITY irqPriority,
+                 MCU::DMA_CH txDma = MCU::DMA_NONE)
                 : reg_( *(reinterpret_cast<Reg*>(u.addr)) ),
                   buffer_( buffer ),
                   irqPriorty_( irqPriority ),
                   irqn_( u.irqn ),
-                  baud_( baudVal )
+                  baud_( baudVal ),
+                  txDma_( txDma, u.txDmaReq ),
+                  hasFifo_( u.hasFifo )
                 {
-                { InterruptLock lock; u.init(); } //rcc
-                GpioPin(u.txPin).alternate( u.txAltFunc );
-                baud();
-                Nvic::setFunction( irqn_, this, irqPriorty_ );
-                txOn();
+                init( u );
+                }
+
+                //tx and rx (rx via rxne irq into rxBuffer, or with rxDma the rxBuffer is
+                //a circular dma buffer)
+                template<unsigned N, unsigned NR>
+Uart            (MCU::uart_t u, u32 baudVal, std::array<u8,N>& buffer, std::array<u8,NR>& rxBuffer, 
+                 Nvic::IRQ_PRIORITY irqPriority, MCU::DMA_CH txDma = MCU::DMA_NONE, MCU::DMA_CH rxDma = MCU::DMA_NONE)
+                : reg_( *(reinterpret_cast<Reg*>(u.addr)) ),
+                  buffer_( buffer ),
+                  rxBuffer_( rxBuffer ),
+                  irqPriorty_( irqPriority ),
+                  irqn_( u.irqn ),
+                  baud_( baudVal ),
+                  txDma_( txDma, u.txDmaReq ),
+                  rxDma_( rxDma, u.rxDmaReq ),
+                  rxBuf_( rxBuffer.data() ),
+                  rxSize_( NR ),
+                  hasFifo_( u.hasFifo )
+                {
+                init( u );
+                GpioPin(u.rxPin).alternate( u.rxAltFunc );
+                rxOn();
                 }
 
                 }; //Uart
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Util.hpp"
+#include "Uart.hpp"
+#include "Ownership.hpp"
+#include "PrintBuffer.hpp"
+#include <string_view>
+
+
+//........................................................................................
+
+                // message granular uart sharing- a task formats a complete message into
+                // its own scratch buffer (PrintBuffer), and send() appends the whole
+                // message to the uart tx buffer in 1 write, or nothing if there is no
+                // room for all of it right now- so tasks never interleave their output
+                // and never have to wait for another task to finish with the uart
+
+                // each message has its own format state (the PrintBuffer), so a message
+                // should set what it needs (colors, dec/hex, etc.)
+
+                // tasks only (all tasks run at the same level, so a send is not
+                // interrupted by another send), and a task that needs the uart to itself
+                // can still use the Ownership- send() then fails until it is closed
+                // (and while Ownership waiters are queued)
+
+                //  std::array<char,128> buf;
+                //  PrintBuffer msg{ buf };
+                //  msg, fg<WHITE>(), now(), " hello", endl;
+                //  if( not board.uartMux.send(msg) ) return false; //no room, try again
+
+////////////////
+class
+UartMux
+////////////////
+                {
+
+                Ownership<Uart>&    own_;
+                Uart&               uart_;
+                u32                 sentCount_{ 0 };
+                u32                 fullCount_{ 0 }; //sends refused (no room, owned, waiters)
+                u32                 truncCount_{ 0 }; //truncated messages not sent
+
+public:
+
+UartMux         (Ownership<Uart>& own, Uart& uart)
+                : own_( own ),
+                  uart_( uart )
+                {
+                }
+
+                //true if a send of n bytes would be taken now- to check before building
+                //a message that has a side effect (like a Telemetry sequence number)
+                bool
+fits            (u32 n)
+                {
+                if( own_.isOwned() or own_.hasWaiters() ) return false;
+                if( uart_.overflowPolicy() != Uart::BLOCK ) return true;
+                u32 free = uart_.bufferFree();
+                return n <= free or free == uart_.bufferSize();
+                }
+
+                //whole message or nothing, false if no room (or the uart is owned, or
+                //has Ownership waiters- they get the uart first)
+                //a message larger than the tx buffer is sent when the buffer is empty
+                //(then waits for room as it goes, as a normal write)
+                //with a uart overflow policy other than BLOCK, the policy applies to
+                //the whole message instead and the message is done (true) either way
+                //(see Uart::writeMessage, droppedMsgs)
+                bool
+send            (std::string_view s)
+                {
+                u32 n = s.size();
+                if( not fits(n) ){ fullCount_++; return false; }
+                if( uart_.overflowPolicy() != Uart::BLOCK ) uart_.writeMessage( s.data(), n );
+                else uart_.write( s.data(), n );
+                sentCount_++;
+                return true;
+                }
+
+                //a truncated message (the PrintBuffer was too small) is not sent, as
+                //its cut off line would run into the next message, and is counted in
+                //truncCount- true is returned, a retry would only be truncated again
+                bool
+send            (PrintBuffer& msg)
+                {
+                if( msg.isTruncated() ){ truncCount_++; return true; }
+                return send( msg.view() );
+                }
+
+                auto
+sentCount       (){ return sentCount_; }
+                auto
+fullCount       (){ return fullCount_; }
+                auto
+truncCount      (){ return truncCount_; }
+                auto
+bufferUsedMax   (){ return uart_.bufferUsedMax(); }
+
+                }; //UartMux
+
+//........................................................................................
@@ -20,7 +20,9 @@ MCU
 
                 enum { 
                     RCC_BASE = 0x4002'1000, 
-                    RCC_USART2ENbm = 1<<17,
+                    RCC_USART2ENbm = 1<<17, RCC_USART1ENbm = 1<<14,
+                    RCC_DMA1ENbm = 1<<0, RCC_CRCENbm = 1<<12,
+                    RCC_TIM2ENbm = 1<<0,
                     RCC_LPTIM2ENbm = 1<<30, RCC_LPTIM1ENbm = 1<<31, LPTIM2SELbp = 20, LPTIM1SELbp = 18, LPTIMSELbm = 3,
                     LSIONbm = 1 
                     };
@@ -40,6 +42,19 @@ USARTn          { USART1_BASE = 0x4001'3800, USART2_BASE = 0x4000'4400 };
                 enum 
 LPTIMn          { LPTIM1_BASE = 0x4000'7C00, LPTIM2_BASE = 0x4000'9400 };
 
+                enum 
+TIMn            { TIM2_BASE = 0x4000'0000 };
+
+                enum { DMA1_BASE = 0x4002'0000, DMAMUX1_BASE = 0x4002'0800 };
+
+                enum { CRC_BASE = 0x4002'3000 };
+
+                enum //dma1 channels (dmamux channel = dma channel-1)
+DMA_CH          { DMA1_CH1, DMA1_CH2, DMA1_CH3, DMA1_CH4, DMA1_CH5, DMA_NONE };
+
+                enum //dmamux request id's
+DMAREQ          { USART1_RX_REQ = 50, USART1_TX_REQ, USART2_RX_REQ, USART2_TX_REQ };
+
                 enum
 PIN             { // 0bPPPPpppp P=port 0-n, p=pin 0-15, enum=port*16+p, port=enum/16, pin=enum%16
                 PA0, PA1, PA2, PA3, PA4, PA5, PA6, PA7,
@@ -60,7 +75,8 @@ ALTFUNC         { AF0, AF1, AF2, AF4 = 4, AF5, AF6, AF7 };
 
 
                 enum
-IRQn            : int { SYSTICK_IRQ = -1, USART1_IRQ = 27, USART2_IRQ, LPTIM1_IRQ = 17, LPTIM2_IRQ };
+IRQn            : int { SYSTICK_IRQ = -1, USART1_IRQ = 27, USART2_IRQ, LPTIM1_IRQ = 17, LPTIM2_IRQ,
+                      TIM2_IRQ = 15, DMA1_CH1_IRQ = 9, DMA1_CH2_3_IRQ, DMA1_CH4_5_IRQ };
 
 
                 //used by Uart class
@@ -73,6 +89,9 @@ uart_t          = struct {
                     ALTFUNC     rxAltFunc;
                     vvfunc_t    init; //such as enable uart in rcc
                     IRQn        irqn;
+                    DMAREQ      txDmaReq;
+                    DMAREQ      rxDmaReq;
+                    bool        hasFifo; //8 byte tx/rx fifo's (USART1)
                     };
 
                 //Uart2, TX=PA2,RX=PA3, HSI16
@@ -81,7 +100,34 @@ Uart2_A2A3      {   USART2_BASE,    //Usart2 base address
                     PA2, AF1,       //tx pin, alt function
                     PA3, AF1,       //rx pin, alt function
                     []{ RCCreg.APBENR1 or_eq RCC_USART2ENbm; }, //init rcc
-                    USART2_IRQ      //IRQn
+                    USART2_IRQ,     //IRQn
+                    USART2_TX_REQ,  //dmamux request id's, tx, rx
+                    USART2_RX_REQ,
+                    false           //no fifo
+                    };
+
+                //Uart1, TX=PA9,RX=PA10
+                static constexpr uart_t
+Uart1_A9A10     {   USART1_BASE,    //Usart1 base address
+                    PA9, AF1,       //tx pin, alt function
+                    PA10, AF1,      //rx pin, alt function
+                    []{ RCCreg.APBENR2 or_eq RCC_USART1ENbm; }, //init rcc
+                    USART1_IRQ,     //IRQn
+                    USART1_TX_REQ,  //dmamux request id's, tx, rx
+                    USART1_RX_REQ,
+                    true            //fifo
+                    };
+
+                //Uart1, TX=PB6,RX=PB7
+                static constexpr uart_t
+Uart1_B6B7      {   USART1_BASE,    //Usart1 base address
+                    PB6, AF0,       //tx pin, alt function
+                    PB7, AF0,       //rx pin, alt function
+                    []{ RCCreg.APBENR2 or_eq RCC_USART1ENbm; }, //init rcc
+                    USART1_IRQ,     //IRQn
+                    USART1_TX_REQ,  //dmamux request id's, tx, rx
+                    USART1_RX_REQ,
+                    true            //fifo
                     };
                
 
@@ -116,6 +162,21 @@ RCCreg.APBRSTR1 and_eq compl RCC_LPTIM2ENbm;
                     LPTIM2_IRQ
                     };
 
+
+                using 
+tim_t           = struct {
+                    TIMn        addr;
+                    vvfunc_t    init; //such as enable timer in rcc
+                    IRQn        irqn;
+                    };
+
+                //Tim2, 32bit timer, clock is PCLK (cpu speed)
+                static constexpr tim_t
+Tim2            {   TIM2_BASE,
+                    []{ RCCreg.APBENR1 or_eq RCC_TIM2ENbm; }, //init rcc
+                    TIM2_IRQ
+                    };
+
                 } //MCU
 
 //........................................................................................
@@ -11,6 +11,11 @@
 #include "Print.hpp"
 #include "MorseCode.hpp"
 #include "Lptim.hpp"
+#include "ClockSync.hpp"
+#include "Benchmark.hpp"
+#include "BinLog.hpp"
+#include "PrintBuffer.hpp"
+#include "Telemetry.hpp"
 
 
 //........................................................................................
@@ -48,15 +53,21 @@
                     ~DebugPin(){ if constexpr( DEBUG_PIN ) board.debugPin.off(); }
                 };
 
+                //uart not available, if in the uart waiter list the task waits for its
+                //turn (see Ownership, Tasks::wait), else false (run again next time)
+                //      Open device{ board.uart, Tasks_t::id(task) };
+                //      if( not device ) return waitFor( device, task );
+                static bool
+waitFor         (Open<Uart>& device, Task_t& task)
+                {
+                return device.isWaiting() ? tasks.wait( task ) : false;
+                }
+
 //........................................................................................
 
                 static bool
 printTask       (Task_t& task)
                 {
-                Open device{ board.uart };                
-                if( not device ) return false; //false = try again
-                auto& uart{ *device.pointer() };
-
 auto t = now();
 auto tdly = (t - task.runat).count();
 static Systick::rep max_tdly = 0, min_tdly = 1000000;
@@ -68,31 +79,104 @@ if( tdly < min_tdly ) min_tdly = tdly;
                 // if( ti > milliseconds(600) ) ti = milliseconds(400);
                 // task.interval = ti; //set new interval
                 auto new_interval = random.read<u16>(10,99);
-                task.interval = milliseconds( new_interval );
                 static u16 n = 0;
+                static TimeStamp ts; //cached time fields, only the us are formatted in most calls
 
+                //message formatted here, then sent whole (no uart owner needed)
+                std::array<char,256> buf;
+                PrintBuffer msg{ buf };
                 // , style (for << style just replace all , with <<
-                uart,
-                    fg(WHITE), t, 
-                    fg(GREEN), " [printTask][", Hex0x(8,reinterpret_cast<u32>(task.func)), ']',
-                    fg(WHITE*0.4), " us late: ", dec_(6,tdly), '[', min_tdly, '/', max_tdly, ']',
-                    fg(50,90,150), " run count: ", dec_(5,n), '[', Hex0x(4,n), ']', 
-                    fg(BLUE*1.5), " new interval: ", new_interval, endl;
+                msg,
+                    fg<WHITE>(), ts(t), 
+                    fg<GREEN>(), " [printTask][", Hex0x(8,reinterpret_cast<u32>(task.func)), ']',
+                    fg<WHITE*0.4>(), " us late: ", dec_(6,tdly), '[', min_tdly, '/', max_tdly, ']',
+                    fg<Rgb{50,90,150}>(), " run count: ", dec_(5,n), '[', Hex0x(4,n), ']', 
+                    fg<BLUE*1.5>(), " new interval: ", new_interval, endl;
+                if( not board.uartMux.send(msg) ) return false; //no room, try again
 
+                task.interval = milliseconds( new_interval );
                 n++;
-                device.close();
                 return true;
                 } //printTask
 
 //........................................................................................
 
+                //deferred binary log, the same info as printTask but only a BinLog record
+                //is stored (a few us), the text is created on the pc-
+                //  bin/logdecode bin/project.elf /dev/ttyACM0
+                //set true to use logTask in place of printTask
+                static constexpr auto DEFERRED_LOG{ false };
+                static std::array<u8,512> binlogBuffer;
+                static BinLog binlog{ binlogBuffer };
+
                 static bool
-printRandom     (Task_t& task)
+logTask         (Task_t& task)
                 {
-                Open device{ board.uart };                
-                if( not device ) return false; //false = try again
-                auto& uart{ *device.pointer() };
+                auto t = now();
+                auto tdly = (t - task.runat).count();
+                static Systick::rep max_tdly = 0, min_tdly = 1000000;
+                if( tdly > max_tdly ) max_tdly = tdly;
+                if( tdly < min_tdly ) min_tdly = tdly;
+
+                DebugPin dp;                
+                auto new_interval = random.read<u16>(10,99);
+                task.interval = milliseconds( new_interval );
+                static u16 n = 0;
+
+                BINLOG( binlog, "{} [logTask] us late: {:6}[{}/{}] run count: {:5}[{:#06X}] new interval: {}\n",
+                        t, tdly, min_tdly, max_tdly, n, n, new_interval );
+                n++;
+                return true;
+                } //logTask
 
+                //BinLog records -> uart
+                static bool
+logDrain        (Task_t& task)
+                {
+                if( binlog.isEmpty() ) return true;
+                Open device{ board.uart, Tasks_t::id(task) };
+                if( not device ) return waitFor( device, task );
+                binlog.drain( *device.pointer() );
+                device.close();
+                return true;
+                }
+
+//........................................................................................
+
+                //binary telemetry, the same info as printTask as a Telemetry frame (about
+                //30 bytes instead of 200+ of ansi text), decoded on the pc-
+                //  bin/teldecode /dev/ttyACM0
+                //set true to use telTask in place of printTask
+                static constexpr auto TELEMETRY{ false };
+                static Telemetry telemetry;
+
+                static bool
+telTask         (Task_t& task)
+                {
+                auto t = now();
+                auto tdly = (t - task.runat).count();
+                static Systick::rep max_tdly = 0, min_tdly = 1000000;
+                if( tdly > max_tdly ) max_tdly = tdly;
+                if( tdly < min_tdly ) min_tdly = tdly;
+
+                DebugPin dp;
+                auto new_interval = random.read<u16>(10,99);
+                static u16 n = 0;
+
+                enum { PRINTTASK_REC = 1, PRINTTASK_FIELDS = 6 }; //record type, fields
+                //no room, try again (checked before record, which uses a sequence number)
+                if( not board.uartMux.fits(Telemetry::frameMax(PRINTTASK_FIELDS)) ) return false;
+                board.uartMux.send( telemetry.record(PRINTTASK_REC, t, tdly, min_tdly, max_tdly, n, new_interval) );
+                task.interval = milliseconds( new_interval );
+                n++;
+                return true;
+                } //telTask
+
+//........................................................................................
+
+                static bool
+printRandom     (Task_t& task)
+                {
 auto t = now();
 auto tdly = (t - task.runat).count();
 static Systick::rep max_tdly = 0, min_tdly = 1000000;
@@ -101,17 +185,19 @@ if( tdly < min_tdly ) min_tdly = tdly;
 
                 DebugPin dp;
                 auto r = random.read();
-
-                uart,
-                    fg(WHITE), t, " [printRandom[", Hex0x(8,reinterpret_cast<u32>(task.func)), ']',
-                    fg(WHITE*0.4), " us late: ", dec_(6,tdly), '[', min_tdly, '/', max_tdly, ']',
-                    fg(20,200,255), " random: ",
-                    fg(20,255,200), Hex0x(8,r),
-                    fg(50,75,200), " uart buffer max used: ", uart.bufferUsedMax(),
+                static TimeStamp ts;
+
+                std::array<char,256> buf;
+                PrintBuffer msg{ buf };
+                msg,
+                    fg<WHITE>(), ts(t), " [printRandom[", Hex0x(8,reinterpret_cast<u32>(task.func)), ']',
+                    fg<WHITE*0.4>(), " us late: ", dec_(6,tdly), '[', min_tdly, '/', max_tdly, ']',
+                    fg<Rgb{20,200,255}>(), " random: ",
+                    fg<Rgb{20,255,200}>(), Hex0x(8,r),
+                    fg<Rgb{50,75,200}>(), " uart buffer max used: ", board.uartMux.bufferUsedMax(),
                         endl, FMT::reset, normal;
 
-                device.close();
-                return true;
+                return board.uartMux.send( msg ); //false = no room, try again
                 } //printRandom
 
 
@@ -171,38 +257,31 @@ Atask
 ////////////////
                 {
                 u32 runCount_{ 0 };
-                Open<Uart> device_{ board.uart };
-                u32 openFailCount_{ 0 };
+                u32 sendFailCount_{ 0 };
 
 public:
 
                 bool
 run             (Task_t& task)
                 {                            
-                if( not device_ ){
-                    openFailCount_++;
-                    return false; //false = try again
-                    }
-                auto& uart{ *device_.pointer() };
-
-
                 Rgb color{ random.read<u8>(10,255), 
                             random.read<u8>(10,255), 
                             128 };
 
                 ++runCount_;
-                //if( runCount_ bitand 1 ){
 auto t = now();
 auto tdly = (t - task.runat).count();
-                    uart,
-                        fg(WHITE), t, space, dec_(6,tdly), fg(color), 
-                        " [", Hex0x(8,reinterpret_cast<u32>(this)),
-                        "][", dec0(10,runCount_), "][", dec0(10,openFailCount_);
-                    //return false;
-                    //}
-                uart, "] Hello World", endl, normal;
-
-                device_.close();
+                std::array<char,160> buf;
+                PrintBuffer msg{ buf };
+                msg,
+                    fg<WHITE>(), t, space, dec_(6,tdly), fg(color), 
+                    " [", Hex0x(8,reinterpret_cast<u32>(this)),
+                    "][", dec0(10,runCount_), "][", dec0(10,sendFailCount_),
+                    "] Hello World", endl, normal;
+                if( not board.uartMux.send(msg) ){
+                    sendFailCount_++;
+                    return false; //false = try again
+                    }
                 task.interval = milliseconds( random.read<u16>(100,500) );
                 return true; //update interval
                 }
@@ -212,28 +291,36 @@ auto tdly = (t - task.runat).count();
 //........................................................................................
 
                 static inline bool
-showRandSeeds   (Task_t& task)
+showRandSeeds   (Task_t&)
                 { //run once, show 2 seed values use in Random (RandomGenLFSR16)
-                Open device{ board.uart };                
-                if( not device ) return false; //false = try again
-                auto& uart{ *device.pointer() };
-
-                if( task.interval != 0ms ){ //10s wait period done
-                    task.interval = 0ms; //so task is deleted
-                    device.close();
-                    return true; //this task gets deleted
-                    }
-
-                //initial interval of 0ms, print data
-                uart,
+                std::array<char,128> buf;
+                PrintBuffer msg{ buf };
+                msg,
                     normal, endl,
                     "   initial seed values for random:", endl, endl,
                     "     seed0: ", Hex0x(8,random.seed0()), endl,
                     "     seed1: ", Hex0x(8,random.seed1()), endl, 
-                    endl, dec;
+                    endl;
+                return board.uartMux.send( msg ); //false = no room, try again
+                }
+
+//........................................................................................
+
+                static bool
+showEpoch       (Task_t& task)
+                { //run once, if systimer resumed its time after a reset show where the
+                  //time discontinuity is (time between the reset and resume time is lost)
+                if( systimer.epoch().time_since_epoch() == 0us ) return true; //power on
+                Open device{ board.uart, Tasks_t::id(task) };
+                if( not device ) return waitFor( device, task );
+                auto& uart{ *device.pointer() };
+
+                uart,
+                    normal, endl,
+                    "   time resumed after reset at: ", systimer.epoch(), 
+                    " (reset count: ", debugram.RESET_COUNT, ')', endl, endl;
 
-                //hold uart for 5s so we can view
-                task.interval = 5s;
+                device.close();
                 return true;
                 }
 
@@ -250,31 +337,68 @@ timePrintu32    () //test Print's u32 conversion speed (view with logic analyzer
                 uart << bin; //set as needed
                 while(1){
                     board.debugPin.on();
-                    uart << v; //dec 307us, hex 298us, oct 417, bin 693us
+                    uart << v; //dec 307us, hex 298us, oct 417, bin 693us (with a divmod per digit,
+                                    //before the shift/mask and reciprocal kernels)
                     board.debugPin.off();
                     delay( 20ms );
                     }
                 }
 
+//........................................................................................
+
+                static bool
+clockBench      (Task_t& task)
+                { //run once, print the cost of the clock functions (cpu cycles)
+                Open device{ board.uart, Tasks_t::id(task) };
+                if( not device ) return waitFor( device, task );
+                ClockBench::run( *device.pointer() );
+                device.close();
+                return true;
+                }
+
 //........................................................................................
 
                 static bool
 printDouble     (Task_t&)
                 {
-                Open device{ board.uart };                
-                if( not device ) return false; //false = try again
-                auto& uart{ *device.pointer() };
-
                 static auto d{ 0.1 };
                 DebugPin dp;
 
-                uart,
-                    fg(WHITE), now(), space, "double: ", setwf(10,' '), setprecision(6), d, endl;
+                std::array<char,96> buf;
+                PrintBuffer msg{ buf };
+                msg,
+                    fg<WHITE>(), now(), space, "double: ", setwf(10,' '), setprecision(6), d, endl;
+                if( not board.uartMux.send(msg) ) return false; //no room, try again
                 d = d*1.0001;
+                return true;
+                } //printDouble
+
+//........................................................................................
 
+                //host time sync over the uart (host side is tools/clocksync.cpp), 
+                //corrects systimer rate/offset to the host clock
+                static ClockSync<Lptim1ClockLSI> clockSync;
+
+                static bool
+clockSyncTask   (Task_t& task)
+                {
+                //received bytes read in place (zero copy), up to a complete line
+                while( not clockSync.isReplyPending() ){
+                    u32 n;
+                    auto p = board.uartReadSpan( n );
+                    if( n == 0 ) break;
+                    u32 i = 0;
+                    while( i < n and not clockSync.rx(p[i++]) ){}
+                    board.uartReadDone( i );
+                    }
+                if( not clockSync.isReplyPending() ) return true;
+                //uart idle when we own it, so reply goes out now (no added tx delay)
+                Open device{ board.uart, Tasks_t::id(task) };
+                if( not device ) return waitFor( device, task );
+                clockSync.reply( *device.pointer() );
                 device.close();
                 return true;
-                } //printRandom
+                }
 
 //........................................................................................
 
@@ -353,17 +477,30 @@ main            ()
                 //we are using lptim for systimer which has a fixed clock, so no need to update
 
 
+                //tasks waiting for the uart are notified when it is their turn
+                board.uart.setNotify( [](u32 w){ Tasks_t::notify(w); } );
+
                 //add tasks
 
                 //show Random seed values at boot to see if they look ok
                 //run now, run only once 
-                //(tasl will hold onto the uart for 5s so we have a chance to read the output)
                 // tasks.insert( showRandSeeds );
+
+                //if time was resumed after a reset, show the resume time (run once)
+                tasks.insert( showEpoch );
+                //clock function costs (also starts Systick, which then wakes the cpu every 1ms)
+                // tasks.insert( clockBench );
                 
                 tasks.insert( ledMorseCode, 80ms ); //interval is morse code DOT length
-                tasks.insert( printTask, 50ms );
+                if constexpr( DEFERRED_LOG ){
+                    tasks.insert( logTask, 50ms, true );
+                    tasks.insert( logDrain, 20ms );
+                    }
+                else if constexpr( TELEMETRY ) tasks.insert( telTask, 50ms, true );
+                else tasks.insert( printTask, 50ms, true ); //low jitter (us late should be ~0)
                 tasks.insert( printRandom, 250ms );
                 tasks.insert( checkRstPin, 1000ms );
+                tasks.insert( clockSyncTask, 1000ms ); //run on uart rx events, this is a backstop
                 // tasks.insert( printDouble, 100ms );
 
                 // tasks.insert( task1run, 100ms );
@@ -375,15 +512,23 @@ main            ()
                 //so all tasks are interruptable, but not from other tasks
                 while(1){ 
                     auto nextRunAt = tasks.run(); //run returns time of next task
-                    systimer.nextWakeup( nextRunAt ); //code in progess
-                    while( nextRunAt > now() ){ //no need to run tasks until nextRunAt
+                    //wakeup set early if next task is low jitter (tasks.run will busy-wait
+                    //the remaining time), wakeAt is the time the wakeup was set for
+                    auto wakeAt = systimer.nextWakeup( nextRunAt, tasks.nextIsLowJitter() );
+                    bool rxEvent = false, notified = false;
+                    while( wakeAt > now() and not rxEvent and not notified ){ //no need to run tasks until wakeAt
                         //no need to check time until the next systick irq
                         //(other interrupts may be in use
 
                         //using wasIrq to check if a 'time' irq was run
                         //(so we can go back to sleep if was something like a uart irq)
-                        while( not systimer.wasIrq() ) CPU::waitIrq();
+                        //uart rx line went idle (a burst was received) also wakes us, and
+                        //a waiting task being notified
+                        while( not systimer.wasIrq() and not (rxEvent = board.uartRxEvent()) 
+                               and not (notified = tasks.wasNotified()) ) CPU::waitIrq();
                         }
+                    //rx is not polled, the rx task runs on the rx line idle event
+                    if( rxEvent ) tasks.run( clockSyncTask );
                     }
 
                 } //main
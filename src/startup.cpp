@@ -36,7 +36,7 @@ errorFunc       ()
                 u32* ram = debugramStart;
                 asm( "MRS %0, msp" : "=r" (msp) );
                 for( auto i = 0; i < 8; i++ ) *ram++ = *msp++;
-                //other data can be saved if wanted (20 more u32's available)
+                //other data can be saved if wanted (debugram.FREE)
                 //then software reset
                 Scb::swReset();
                 }
@@ -0,0 +1,76 @@
+//........................................................................................
+
+                // host run of the FMT benchmarks (include/Benchmark.hpp), times are in ns
+                // from steady_clock- useful to compare formatting changes, the target
+                // numbers (cpu cycles) come from ClockBench/Benchmark on the board
+
+                // build-   make tools
+                // run-     bin/bench [runs]
+
+//........................................................................................
+
+#include "Benchmark.hpp"
+#include "Format.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+//........................................................................................
+
+////////////////
+class
+StdoutPrint     : public FMT::Print
+////////////////
+                {
+                bool
+write           (const char c) override { return putchar(c) != EOF; }
+                u32
+write           (const char* s, u32 n) override { return fwrite( s, 1, n, stdout ); }
+                };
+
+//........................................................................................
+
+                //a time_point like the target clocks produce (us, i64 rep)
+                struct UsClock { using duration = std::chrono::microseconds; };
+                using time_point = std::chrono::time_point<UsClock, UsClock::duration>;
+
+                int
+main            (int argc, char** argv)
+                {
+                using namespace FMT;
+                StdoutPrint out;
+                PrintDiscard sink;
+                Benchmark bench{ out, argc > 1 ? static_cast<u32>(atoi(argv[1])) : 10000 };
+
+                volatile u32 u = 0xFFFFFFFF; //volatile, so the value is not known at compile time
+                volatile i64 i = -1234567890;
+                volatile double d = 12345.678901;
+                volatile float f = 12345.678f;
+                volatile i32 q = 0x3039'ADD3; //Q16.16 12345.678...
+                auto tp = time_point( std::chrono::microseconds(123LL*86400'000000 + 3723'456789) );
+                TimeStamp ts;
+
+                bench.header( "FMT" )
+                     .run( "u32 dec", [&]{ sink << dec << u; } )
+                     .run( "u32 hex", [&]{ sink << hex << u; } )
+                     .run( "u32 oct", [&]{ sink << oct << u; } )
+                     .run( "u32 bin", [&]{ sink << bin << u; } )
+                     .run( "u32 dec_(12)", [&]{ sink << dec_(12,u); } )
+                     .run( "i64 dec (fits i32)", [&]{ sink << dec << i; } )
+                     .run( "i64 dec (19 digits)", [&]{ sink << dec << i*i; } )
+                     .run( "u64 hex (16 digits)", [&]{ sink << hex << static_cast<u64>(i*i); } )
+                     .run( "<< Hex0x(8,u)", [&]{ sink << Hex0x(8,u); } )
+                     .run( "format<{:#010X}>", [&]{ format<"{:#010X}">( sink, u ); } )
+                     .run( "<< dec_(6,i), Hex0x, str", [&]{ sink << dec_(6,static_cast<i32>(i)) << " [" << Hex0x(8,u) << "] " << "text"; } )
+                     .run( "format<{:>6} [{:#010X}] {}>", [&]{ format<"{:>6} [{:#010X}] {}">( sink, static_cast<i32>(i), u, "text" ); } )
+                     .run( "double", [&]{ sink << dec << d; } )
+                     .run( "float", [&]{ sink << dec << f; } )
+                     .run( "Q16.16", [&]{ sink << dec << Q16{q}; } )
+                     .run( "double setprecision(3)", [&]{ sink << setprecision(3) << d << setprecision(9); } )
+                     .run( "time_point <<", [&]{ sink << tp; } )
+                     .run( "TimeStamp (same second)", [&]{ sink << ts(tp); } )
+                     .run( "TimeStamp (next second)", [&]{ tp += std::chrono::seconds(1); sink << ts(tp); } )
+                     .run( "fg(r,g,b)", [&]{ sink << ANSI::fg(u,u>>8,u>>16); } )
+                     .run( "fg<WHITE>()", [&]{ sink << ANSI::fg<ANSI::WHITE>(); } );
+                return 0;
+                }
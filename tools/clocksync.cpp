@@ -0,0 +1,244 @@
+//........................................................................................
+
+                // host side of the ClockSync exchange (include/ClockSync.hpp)
+
+                // build (host compiler)-   make tools
+                // run against the board-   bin/clocksync /dev/ttyACM0 [count] [interval_ms]
+                // self check (no board)-   bin/clocksync --pty
+
+                // host time is the system clock in us (unix time), so once synced the
+                // device times are also unix times and device logs line up with host logs
+
+                // --pty runs the device side (the same ClockSync class) in a thread on the
+                // other end of a pty pair, with a simulated clock that runs 1.5% fast (like
+                // an uncalibrated lsi)- exits with 0 if the offset and skew converge
+
+//........................................................................................
+
+#include "ClockSync.hpp"
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+                using namespace std::chrono;
+
+                static i64
+hostUs          (){ return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count(); }
+
+//........................................................................................
+
+////////////////
+class
+SimClock
+////////////////
+                {
+
+                static constexpr double SKEW_{ 0.015 }; //1.5% fast
+
+                static i64
+realUs          (){ return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count(); }
+
+                static inline i64 baseReal_{ realUs() };
+                static inline double baseUs_{ 0 }; //device time at baseReal_
+                static inline i32 ppb_{ 0 };
+
+                static double
+at              (i64 real){ return baseUs_ + (real - baseReal_) * (1.0 + SKEW_) * (1.0 + ppb_ * 1e-9); }
+
+                static void
+rebase          (){ auto r = realUs(); baseUs_ = at(r); baseReal_ = r; }
+
+public:
+
+                using duration = microseconds;
+                using time_point = std::chrono::time_point<SimClock, duration>;
+
+                static time_point
+now             (){ return time_point( duration(static_cast<i64>(at(realUs()))) ); }
+
+                static void
+adjust          (i32 ppb){ rebase(); ppb_ = ppb; }
+
+                static i32
+adjust          (){ return ppb_; }
+
+                static void
+step            (duration d){ if( d.count() > 0 ){ rebase(); baseUs_ += d.count(); } }
+
+                static constexpr i64
+skewPpb         (){ return static_cast<i64>(SKEW_ * 1e9); }
+
+                }; //SimClock
+
+//........................................................................................
+
+                //Print to a file descriptor, a line is written in one write (so the
+                //timestamp taken before the line is not skewed by per char writes)
+////////////////
+class
+FdPrint         : public FMT::Print
+////////////////
+                {
+
+                int fd_;
+                std::string line_;
+
+                bool
+write           (const char c) override
+                {
+                line_ += c;
+                if( c != '\n' ) return true;
+                auto ok = ::write( fd_, line_.data(), line_.size() ) == static_cast<ssize_t>(line_.size());
+                line_.clear();
+                return ok;
+                }
+
+public:
+
+FdPrint         (int fd) : fd_(fd) {}
+
+                }; //FdPrint
+
+//........................................................................................
+
+                static bool
+setRaw          (int fd, speed_t baud)
+                {
+                termios t;
+                if( tcgetattr(fd, &t) ) return false;
+                cfmakeraw( &t );
+                if( baud ) cfsetspeed( &t, baud );
+                return tcsetattr( fd, TCSANOW, &t ) == 0;
+                }
+
+                //read a line (without the newline), at = host time first char seen
+                //false if timeout
+                static bool
+readLine        (int fd, std::string& s, i64& at, int timeoutMs)
+                {
+                s.clear();
+                while( true ){
+                    pollfd p{ fd, POLLIN, 0 };
+                    if( poll(&p, 1, timeoutMs) <= 0 ) return false;
+                    char c;
+                    if( read(fd, &c, 1) != 1 ) return false;
+                    if( s.empty() ) at = hostUs();
+                    if( c == '\r' ) continue;
+                    if( c == '\n' ){ if( s.size() ) return true; continue; }
+                    s += c;
+                    }
+                }
+
+                static bool
+hexField        (const std::string& s, int idx, i64& v)
+                {
+                auto pos = 1 + idx*16;
+                if( s.size() < static_cast<size_t>(pos + 16) ) return false;
+                v = static_cast<i64>( strtoull(s.substr(pos, 16).c_str(), nullptr, 16) );
+                return true;
+                }
+
+                static bool
+sendLine        (int fd, char cmd, i64 v)
+                {
+                char buf[20];
+                auto n = snprintf( buf, sizeof buf, "%c%016llx\n", cmd, static_cast<unsigned long long>(v) );
+                return write( fd, buf, n ) == n;
+                }
+
+                struct Result { i64 offset, delay, ppb; };
+
+                //one exchange- T -> R, D -> A
+                static bool
+exchange        (int fd, Result& r)
+                {
+                std::string s;
+                i64 t1, t4, echo, unused;
+                tcflush( fd, TCIFLUSH ); //drop anything stale (like device log output)
+                t1 = hostUs();
+                if( not sendLine(fd, 'T', t1) ) return false;
+                //skip any other output until the R line for this T
+                do{ if( not readLine(fd, s, t4, 500) ) return false;
+                } while( s[0] != 'R' or not hexField(s, 0, echo) or echo != t1 );
+                if( not sendLine(fd, 'D', t4) ) return false;
+                do{ if( not readLine(fd, s, unused, 500) ) return false;
+                } while( s[0] != 'A' );
+                return hexField(s, 0, r.offset) and hexField(s, 1, r.delay) and hexField(s, 2, r.ppb);
+                }
+
+//........................................................................................
+
+                //device side for --pty
+                static std::atomic<bool> simRun{ true };
+
+                static void
+simDevice       (int fd)
+                {
+                ClockSync<SimClock> sync;
+                FdPrint out{ fd };
+                while( simRun ){
+                    pollfd p{ fd, POLLIN, 0 };
+                    if( poll(&p, 1, 10) <= 0 ) continue;
+                    char c;
+                    if( read(fd, &c, 1) != 1 ) break;
+                    if( sync.rx(c) ) sync.reply( out );
+                    }
+                }
+
+                static int
+run             (int fd, int count, int intervalMs, bool isSim)
+                {
+                Result r{};
+                auto good = 0, fails = 0;
+                for( auto i = 0; i < count; i++ ){
+                    if( not exchange(fd, r) ){ printf( "%4d  no reply\n", i ); fails++; continue; }
+                    printf( "%4d  offset: %8lld us  delay: %6lld us  adjust: %10lld ppb\n",
+                            i, (long long)r.offset, (long long)r.delay, (long long)r.ppb );
+                    fflush( stdout );
+                    //converged = small offset (after the first step)
+                    good = (i and llabs(r.offset) < 500) ? good+1 : 0;
+                    std::this_thread::sleep_for( milliseconds(intervalMs) );
+                    }
+                if( not isSim ) return fails == count;
+                //device clock is 1.5% fast, so the correction should be about -1.5%
+                auto skewErr = llabs( r.ppb + SimClock::skewPpb() * 1'000'000'000 / (1'000'000'000 + SimClock::skewPpb()) );
+                auto ok = good >= 10 and skewErr < 1'000'000; //last 10 in range, skew within 0.1%
+                printf( "%s (skew error: %lld ppb)\n", ok ? "converged" : "FAILED", (long long)skewErr );
+                return ok ? 0 : 1;
+                }
+
+//........................................................................................
+
+                int
+main            (int argc, char** argv)
+                {
+                if( argc < 2 ){
+                    fprintf( stderr, "usage: %s <tty> [count] [interval_ms]\n"
+                                     "       %s --pty  (self check with a simulated device)\n", argv[0], argv[0] );
+                    return 2;
+                    }
+
+                if( strcmp(argv[1], "--pty") == 0 ){
+                    auto m = posix_openpt( O_RDWR bitor O_NOCTTY );
+                    if( m < 0 or grantpt(m) or unlockpt(m) ){ perror( "pty" ); return 2; }
+                    auto s = open( ptsname(m), O_RDWR bitor O_NOCTTY );
+                    if( s < 0 or not setRaw(s, 0) ){ perror( "pty" ); return 2; }
+                    std::thread dev{ simDevice, m };
+                    auto ret = run( s, 60, 50, true );
+                    simRun = false;
+                    dev.join();
+                    return ret;
+                    }
+
+                auto fd = open( argv[1], O_RDWR bitor O_NOCTTY );
+                if( fd < 0 or not setRaw(fd, B1000000) ){ perror( argv[1] ); return 2; } //board uart is 1MBaud
+                return run( fd, argc > 2 ? atoi(argv[2]) : 1000000, argc > 3 ? atoi(argv[3]) : 1000, false );
+                }
@@ -0,0 +1,311 @@
+//........................................................................................
+
+                // host check of FMT::Print output against snprintf, and a throughput
+                // comparison (chars per second) of each formatter with its snprintf
+                // equivalent
+
+                // build-   make tools
+                // run-     bin/fmttest [cases] [seed]     (exit 0 if no mismatches)
+
+                // random values (with extra weight on 0, small values and limits), all
+                // bases, showbase, uppercase, showpos, justify, width and fill, for
+                // integers, float/double/Q16.16 (precision 0-9) and strings- each case
+                // resets the Print state, then sets every option, so a failing case can
+                // be repeated from the printed options
+
+                // snprintf produces the digits (and the rounded decimal text for floats),
+                // the sign/prefix/padding layout is the documented Print behavior-
+                //  internal justify pads between sign/prefix and digits (width counts the
+                //      digits only)
+                //  bin/oct/hex print the magnitude of a negative value (no sign)
+                //  + only for a non-zero value, -0.0 prints without a sign
+                //  float width applies to the integer part and is always right justified
+                //  ovf/nan/inf print without padding
+
+//........................................................................................
+
+#include "PrintBuffer.hpp"
+#include "Format.hpp"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+                using namespace FMT;
+
+//........................................................................................
+
+                //one set of Print options
+                struct Opts {
+                    FMT_BASE        base{ dec };
+                    bool            showbase{ false }, upper{ false }, pos{ false };
+                    FMT_JUSTIFY     just{ right };
+                    int             width{ 0 };
+                    char            fill{ ' ' };
+                    int             precision{ 9 };
+                    };
+
+                static std::array<char,256> buf;
+                static PrintBuffer out{ buf };
+
+                static std::mt19937_64 rng;
+                static u32 failed = 0, checked = 0;
+
+                static Print&
+setup           (const Opts& o)
+                {
+                out.clear();
+                return out << reset << o.base << (o.showbase ? showbase : noshowbase)
+                           << (o.upper ? uppercase : nouppercase) << (o.pos ? showpos : noshowpos)
+                           << o.just << setprecision(o.precision) << setwf(o.width, o.fill);
+                }
+
+                static void
+check           (const char* what, const std::string& expect, const Opts& o, const char* value)
+                {
+                checked++;
+                std::string got{ out.view() };
+                if( got == expect ) return;
+                if( failed++ < 20 ){
+                    printf( "FAIL %s %s base %d showbase %d upper %d pos %d just %d width %d fill '%c' precision %d\n"
+                            "     expect [%s]\n     got    [%s]\n",
+                            what, value, o.base, o.showbase, o.upper, o.pos, o.just, o.width, o.fill, o.precision,
+                            expect.c_str(), got.c_str() );
+                    }
+                }
+
+                static std::string
+pad             (const std::string& s, const Opts& o, bool left)
+                {
+                if( static_cast<int>(s.size()) >= o.width ) return s;
+                std::string f( o.width - s.size(), o.fill );
+                return left ? s + f : f + s;
+                }
+
+//........................................................................................
+
+                static u64
+randomU64       ()
+                {
+                static constexpr u64 edges[]{ 0, 1, 9, 10, 99, 100, 255, 256, 65535, 65536, 999999999, 1000000000,
+                    0x7FFFFFFF, 0x80000000, 0xFFFFFFFF, 0x100000000, 9999999999999999999ULL, 0x7FFFFFFFFFFFFFFF,
+                    0x8000000000000000, 0xFFFFFFFFFFFFFFFF };
+                switch( rng() % 4 ){
+                    case 0: return edges[rng() % (sizeof edges / sizeof edges[0])];
+                    case 1: return rng() % 1000;
+                    default: return rng() >> (rng() % 64); //all magnitudes
+                    }
+                }
+
+                static Opts
+randomOpts      ()
+                {
+                static constexpr FMT_BASE bases[]{ bin, oct, dec, hex };
+                static constexpr char fills[]{ ' ', '0', '*' };
+                Opts o;
+                o.base = bases[rng() % 4];
+                o.showbase = rng() % 2;
+                o.upper = rng() % 2;
+                o.pos = rng() % 2;
+                o.just = static_cast<FMT_JUSTIFY>(rng() % 3);
+                o.width = rng() % 3 ? rng() % 31 : 0; //internal fill is limited to the digit buffer, 30 is safe for u32
+                o.fill = fills[rng() % 3];
+                o.precision = rng() % 10;
+                return o;
+                }
+
+                //expected integer output, digits from snprintf
+                static std::string
+expectInt       (u64 mag, bool neg, const Opts& o)
+                {
+                char d[72];
+                bool nz = mag;
+                if( o.base == bin ){
+                    int i = sizeof d;
+                    d[--i] = 0;
+                    do{ d[--i] = '0' + (mag bitand 1); mag >>= 1; } while( mag );
+                    memmove( d, &d[i], sizeof d - i );
+                    }
+                else snprintf( d, sizeof d, o.base == oct ? "%llo" : o.base == dec ? "%llu" : o.upper ? "%llX" : "%llx",
+                               static_cast<unsigned long long>(mag) );
+                std::string pre;
+                if( o.base == bin and o.showbase ) pre = "0b";
+                else if( o.base == oct and o.showbase and nz ) pre = "0";
+                else if( o.base == hex and o.showbase ) pre = "0x";
+                else if( o.base == dec ) pre = neg ? "-" : o.pos and nz ? "+" : "";
+                if( o.just == internal ){
+                    int n = o.width - static_cast<int>(strlen(d));
+                    return pre + std::string( n > 0 ? n : 0, o.fill ) + d;
+                    }
+                return pad( pre + d, o, o.just == left );
+                }
+
+                static void
+testInts        ()
+                {
+                auto o = randomOpts();
+                u64 v = randomU64();
+                char vs[48];
+                snprintf( vs, sizeof vs, "%llu", static_cast<unsigned long long>(v) );
+                auto u = static_cast<u32>(v);
+                auto i = static_cast<i32>(v);
+                auto i64v = static_cast<i64>(v);
+                setup(o) << u;      check( "u32", expectInt(u, false, o), o, vs );
+                setup(o) << i;      check( "i32", expectInt(i < 0 ? (0 - static_cast<u64>(static_cast<u32>(i))) bitand 0xFFFFFFFF : i, i < 0, o), o, vs );
+                setup(o) << v;      check( "u64", expectInt(v, false, o), o, vs );
+                setup(o) << i64v;   check( "i64", expectInt(i64v < 0 ? 0 - v : v, i64v < 0, o), o, vs );
+                }
+
+//........................................................................................
+
+                //expected float output, decimal text from snprintf (round half even on
+                //the exact binary value)
+                static std::string
+expectFloat     (double v, const Opts& o)
+                {
+                if( std::isnan(v) ) return "nan";
+                if( std::isinf(v) ) return "inf";
+                if( std::fabs(v) > 4294967040.0 ) return "ovf";
+                char d[64];
+                snprintf( d, sizeof d, "%.*f", o.precision, std::fabs(v) );
+                std::string s{ d };
+                auto dot = s.find( '.' );
+                std::string ip = s.substr( 0, dot ), fp = dot == std::string::npos ? "" : s.substr( dot );
+                if( v < 0 ) ip = "-" + ip;
+                else if( o.pos and ip != "0" ) ip = "+" + ip;
+                return pad( ip, o, false ) + fp;
+                }
+
+                static double
+randomDouble    ()
+                {
+                static constexpr double edges[]{ 0.0, -0.0, 0.5, 1.5, 2.5, -0.5, 0.125, 0.375, 4294967040.0, 4294967039.5,
+                    0.9999999996, 0.00000000049, 1e-300, 5e-324, 4294967296.0, -1e20, NAN, INFINITY, -INFINITY };
+                switch( rng() % 5 ){
+                    case 0: return edges[rng() % (sizeof edges / sizeof edges[0])];
+                    case 1: return static_cast<double>(rng() % 100000) / std::pow(10.0, rng() % 10) * (rng() % 2 ? 1 : -1);
+                    case 2: return static_cast<double>(rng() % 40000) / 8192.0; //exact binary fractions (ties)
+                    default: return static_cast<double>(static_cast<i64>(rng()) >> 20) / std::ldexp(1.0, rng() % 48);
+                    }
+                }
+
+                static void
+testFloats      ()
+                {
+                auto o = randomOpts();
+                o.base = static_cast<FMT_BASE>( rng() % 2 ? dec : hex ); //base does not apply
+                auto d = randomDouble();
+                auto f = static_cast<float>(d);
+                char vs[48];
+                snprintf( vs, sizeof vs, "%a", d );
+                setup(o) << d;      check( "double", expectFloat(d, o), o, vs );
+                snprintf( vs, sizeof vs, "%a", static_cast<double>(f) );
+                setup(o) << f;      check( "float", expectFloat(f, o), o, vs );
+                //Q16.16 from the low bits
+                auto q = static_cast<i32>(rng());
+                snprintf( vs, sizeof vs, "0x%08X", static_cast<u32>(q) );
+                setup(o) << Q16{q}; check( "Q16", expectFloat(q / 65536.0, o), o, vs );
+                }
+
+                static void
+testStrings     ()
+                {
+                auto o = randomOpts();
+                static constexpr const char* strs[]{ "", "a", "text", "a longer string of chars" };
+                auto s = strs[rng() % 4];
+                setup(o) << s;
+                check( "string", pad(s, o, o.just == left), o, s );
+                }
+
+                //compile time formats, against the equivalent printf format
+                static void
+testFormat      ()
+                {
+                Opts o;
+                auto v = static_cast<u32>(randomU64());
+                auto i = static_cast<i32>(v);
+                char vs[16], e[96];
+                snprintf( vs, sizeof vs, "%u", v );
+                out.clear(); format<"{:>8}|{:<8}|{:+}|{}">( out, i, i, i, v );
+                snprintf( e, sizeof e, "%8d|%-8d|%+d|%u", i, i, i, v );
+                check( "format d", e, o, vs );
+                out.clear(); format<"{:X} {:x} {:o} {:#o} {:08X}">( out, v, v, v, v, v );
+                snprintf( e, sizeof e, "%X %x %o %#o %08X", v, v, v, v, v );
+                check( "format xo", e, o, vs );
+                if( v ){ //printf drops the 0x for 0
+                    out.clear(); format<"{:#010x} {:#x}">( out, v, v );
+                    snprintf( e, sizeof e, "%#010x %#x", v, v );
+                    check( "format #x", e, o, vs );
+                    }
+                }
+
+//........................................................................................
+
+                //chars per second of a formatter and its snprintf equivalent
+                template<typename F, typename S> static void
+throughput      (const char* name, F fmt, S sprintf)
+                {
+                using namespace std::chrono;
+                constexpr u32 N = 200000;
+                auto run = [&](auto f){
+                    u64 chars = 0;
+                    auto t0 = steady_clock::now();
+                    for( u32 i = 0; i < N; i++ ) chars += f( i );
+                    double s = duration<double>(steady_clock::now() - t0).count();
+                    return chars / s / 1e6;
+                    };
+                auto a = run( [&](u32 i){ out.clear(); fmt( i ); return out.size(); } );
+                auto b = run( [&](u32 i){ char t[96]; return static_cast<u64>(sprintf( t, i )); } );
+                printf( "%-28s %8.1f %8.1f %6.2fx\n", name, a, b, a / b );
+                }
+
+                static void
+throughputAll   ()
+                {
+                volatile u32 x = 0x89ABCDEF; //volatile, not known at compile time
+                volatile double d = 12345.678901;
+                printf( "\n%-28s %8s %8s\n", "Mchars/s", "FMT", "snprintf" );
+                throughput( "u32 dec",
+                    [&](u32 i){ out << dec << (x ^ i); },
+                    [&](char* t, u32 i){ return snprintf( t, 96, "%u", x ^ i ); } );
+                throughput( "u32 hex0x(8)",
+                    [&](u32 i){ out << hex0x(8, x ^ i); },
+                    [&](char* t, u32 i){ return snprintf( t, 96, "0x%08x", x ^ i ); } );
+                throughput( "i32 dec_(12)",
+                    [&](u32 i){ out << dec_(12, static_cast<i32>(x ^ i)); },
+                    [&](char* t, u32 i){ return snprintf( t, 96, "%12d", static_cast<i32>(x ^ i) ); } );
+                throughput( "u64 dec",
+                    [&](u32 i){ out << dec << (static_cast<u64>(x) * x + i); },
+                    [&](char* t, u32 i){ return snprintf( t, 96, "%llu", static_cast<unsigned long long>(static_cast<u64>(x) * x + i) ); } );
+                throughput( "double setprecision(6)",
+                    [&](u32 i){ out << setprecision(6) << (d + i); },
+                    [&](char* t, u32 i){ return snprintf( t, 96, "%.6f", d + i ); } );
+                throughput( "string setw(12)",
+                    [&](u32){ out << setw(12) << "text"; },
+                    [&](char* t, u32){ return snprintf( t, 96, "%12s", "text" ); } );
+                throughput( "format<{:>8} {:#010x}>",
+                    [&](u32 i){ format<"{:>8} {:#010x}">( out, static_cast<i32>(x ^ i), x ); },
+                    [&](char* t, u32 i){ return snprintf( t, 96, "%8d %#010x", static_cast<i32>(x ^ i), x ); } );
+                }
+
+//........................................................................................
+
+                int
+main            (int argc, char** argv)
+                {
+                u32 cases = argc > 1 ? atoi(argv[1]) : 200000;
+                rng.seed( argc > 2 ? atoi(argv[2]) : 1 );
+                for( u32 n = 0; n < cases; n++ ){
+                    testInts();
+                    testFloats();
+                    testStrings();
+                    testFormat();
+                    }
+                printf( "%u checks, %u failed\n", checked, failed );
+                throughputAll();
+                return failed ? 1 : 0;
+                }
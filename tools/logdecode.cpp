@@ -0,0 +1,259 @@
+//........................................................................................
+
+                // host decoder for BinLog records (include/BinLog.hpp)
+
+                // build-   make tools
+                // run-     bin/logdecode bin/project.elf /dev/ttyACM0    (uart, 1MBaud)
+                //          bin/logdecode bin/project.elf capture.bin     (a saved capture)
+                //          bin/logdecode bin/project.elf -               (stdin)
+
+                // format strings are read from the .logstr section of the elf, const char*
+                // arguments from the elf loadable sections (rom)
+                // anything in the stream that is not a valid record (normal text output)
+                // is passed through as-is
+
+//........................................................................................
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+                using u8 = uint8_t;
+                using u32 = uint32_t;
+                using i64 = int64_t;
+                using u64 = uint64_t;
+
+//........................................................................................
+
+                //minimal elf32 reader- .logstr contents, and alloc sections for rom strings
+////////////////
+struct
+Elf
+////////////////
+                {
+
+                struct Section { u32 addr; std::vector<u8> data; };
+
+                std::vector<u8>         logstr;
+                std::vector<Section>    rom;
+
+                template<typename T> static T
+get             (const std::vector<u8>& f, u32 off)
+                {
+                T v{};
+                if( off + sizeof v <= f.size() ) memcpy( &v, &f[off], sizeof v );
+                return v;
+                }
+
+                bool
+load            (const char* path)
+                {
+                auto fp = fopen( path, "rb" );
+                if( not fp ) return false;
+                std::vector<u8> f;
+                u8 buf[4096];
+                for( size_t n; (n = fread(buf, 1, sizeof buf, fp)) > 0; ) f.insert( f.end(), buf, buf+n );
+                fclose( fp );
+                if( f.size() < 52 or memcmp(f.data(), "\x7f" "ELF", 4) or f[4] != 1 ) return false; //elf32 only
+                u32 shoff = get<u32>( f, 32 );
+                u32 shentsize = get<uint16_t>( f, 46 ), shnum = get<uint16_t>( f, 48 ), shstrndx = get<uint16_t>( f, 50 );
+                auto sh = [&](u32 i, u32 field){ return get<u32>( f, shoff + i*shentsize + field ); };
+                u32 strOff = sh( shstrndx, 16 );
+                for( u32 i = 0; i < shnum; i++ ){
+                    u32 name = sh(i,0), type = sh(i,4), flags = sh(i,8), addr = sh(i,12), off = sh(i,16), size = sh(i,20);
+                    if( off + size > f.size() or type == 8 ) continue; //NOBITS (bss) has no data
+                    std::string nm = reinterpret_cast<const char*>( &f[strOff + name] );
+                    std::vector<u8> d( f.begin()+off, f.begin()+off+size );
+                    if( nm == ".logstr" ) logstr = d;
+                    else if( flags bitand 2 ) rom.push_back( {addr, d} ); //SHF_ALLOC
+                    }
+                return logstr.size();
+                }
+
+                //0 terminated string at offset in data (empty if out of range)
+                static std::string
+cstr            (const std::vector<u8>& d, u32 off)
+                {
+                std::string s;
+                while( off < d.size() and d[off] ) s += d[off++];
+                return s;
+                }
+
+                std::string
+romString       (u32 addr)
+                {
+                for( auto& s : rom ) if( addr >= s.addr and addr < s.addr + s.data.size() ) return cstr( s.data, addr - s.addr );
+                char b[32]; snprintf( b, sizeof b, "<str 0x%08X?>", addr );
+                return b;
+                }
+
+                }; //Elf
+
+//........................................................................................
+
+                //one argument of a record
+                struct Arg { char code; i64 i; u64 u; double d; };
+
+                //a field spec (same syntax as FMT::format)
+                struct Spec { char fill = ' ', align = 0, sign = '-'; bool alt = false, zero = false; u32 width = 0; char type = 0; };
+
+                static std::string
+padded          (const std::string& s, const Spec& f, char defAlign)
+                {
+                if( s.size() >= f.width ) return s;
+                u32 n = f.width - s.size();
+                auto a = f.align ? f.align : defAlign;
+                u32 l = a == '>' ? n : a == '^' ? n/2 : 0;
+                return std::string( l, f.fill ) + s + std::string( n - l, f.fill );
+                }
+
+                static std::string
+integer         (u64 mag, bool neg, const Spec& f)
+                {
+                int base = f.type == 'x' or f.type == 'X' ? 16 : f.type == 'o' ? 8 : f.type == 'b' ? 2 : 10;
+                const char* tbl = f.type == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+                std::string d;
+                do{ d.insert( d.begin(), tbl[mag % base] ); mag /= base; } while( mag );
+                std::string pre = neg ? "-" : f.sign == '+' ? "+" : f.sign == ' ' ? " " : "";
+                if( f.alt ) pre += base == 16 ? "0x" : base == 2 ? "0b" : base == 8 and d != "0" ? "0" : "";
+                if( f.zero and pre.size() + d.size() < f.width ) d.insert( 0, f.width - pre.size() - d.size(), '0' );
+                return padded( pre + d, f, '>' );
+                }
+
+                //same as the FMT time_point operator<<  "   1d00:01:07.825696"
+                static std::string
+timePoint       (i64 us)
+                {
+                u64 u = us < 0 ? 0 : us;
+                char b[48];
+                snprintf( b, sizeof b, "%4llud%02llu:%02llu:%02llu.%06llu",
+                          (unsigned long long)(u/86400000000ULL), (unsigned long long)(u/3600000000ULL%24),
+                          (unsigned long long)(u/60000000ULL%60), (unsigned long long)(u/1000000ULL%60), (unsigned long long)(u%1000000ULL) );
+                return b;
+                }
+
+                static std::string
+field           (const Arg& a, const Spec& f, Elf& elf, u32 sAddr)
+                {
+                bool isNum = f.type and f.type != 'c' and f.type != 's';
+                switch( a.code ){
+                    case '?': if( not isNum ) return padded( a.u ? "true" : "false", f, '<' ); break;
+                    case 'c': if( not isNum ) return padded( std::string(1, char(a.u)), f, '<' ); break;
+                    case 's': return padded( elf.romString(sAddr), f, '<' );
+                    case 'T': return padded( timePoint(a.i), f, '<' );
+                    case 'f': case 'd': { char b[64]; snprintf( b, sizeof b, "%.9f", a.d ); return padded( b, f, '>' ); }
+                    }
+                bool isSigned = a.code == 'b' or a.code == 'h' or a.code == 'i' or a.code == 'q' or a.code == 'D';
+                if( isSigned ) return integer( a.i < 0 ? 0 - u64(a.i) : u64(a.i), a.i < 0, f );
+                return integer( a.u, false, f );
+                }
+
+//........................................................................................
+
+                //decode a record (id + arg bytes), false if the id or size does not match
+                static bool
+decode          (Elf& elf, const u8* rec, u32 n, std::string& out)
+                {
+                u32 id = rec[0] | (rec[1] << 8);
+                if( id >= elf.logstr.size() ) return false;
+                auto sig = Elf::cstr( elf.logstr, id );
+                auto fmt = Elf::cstr( elf.logstr, id + sig.size() + 1 );
+                //args
+                std::vector<Arg> args;
+                std::vector<u32> sAddr;
+                u32 pos = 2;
+                for( auto c : sig ){
+                    u32 sz = strchr("bB?c", c) ? 1 : strchr("hH", c) ? 2 : strchr("qQdTD", c) ? 8 : 4;
+                    if( pos + sz > n ) return false;
+                    u64 raw = 0;
+                    memcpy( &raw, &rec[pos], sz );
+                    pos += sz;
+                    Arg a{ c, 0, raw, 0 };
+                    if( sz < 8 and strchr("bhi", c) and (raw >> (sz*8-1)) ) raw |= ~0ULL << (sz*8); //sign extend
+                    a.i = static_cast<i64>(raw);
+                    if( c == 'f' ){ float fl; memcpy( &fl, &rec[pos-sz], 4 ); a.d = fl; }
+                    if( c == 'd' ) memcpy( &a.d, &rec[pos-sz], 8 );
+                    args.push_back( a );
+                    sAddr.push_back( static_cast<u32>(raw) );
+                    }
+                if( pos != n ) return false;
+                //format
+                size_t ai = 0;
+                for( size_t i = 0; i < fmt.size(); i++ ){
+                    auto c = fmt[i];
+                    if( (c == '{' or c == '}') and i+1 < fmt.size() and fmt[i+1] == c ){ out += c; i++; continue; }
+                    if( c != '{' ){ out += c; continue; }
+                    Spec f;
+                    auto e = fmt.find( '}', i );
+                    if( e == std::string::npos ) break;
+                    auto s = fmt.substr( i+1, e-i-1 );
+                    i = e;
+                    if( s.size() and s[0] == ':' ){
+                        size_t k = 1;
+                        auto isAlign = [](char a){ return a == '<' or a == '>' or a == '^'; };
+                        if( k+1 < s.size() and isAlign(s[k+1]) ){ f.fill = s[k]; f.align = s[k+1]; k += 2; }
+                        else if( k < s.size() and isAlign(s[k]) ){ f.align = s[k]; k++; }
+                        if( k < s.size() and strchr("+- ", s[k]) ){ f.sign = s[k]; k++; }
+                        if( k < s.size() and s[k] == '#' ){ f.alt = true; k++; }
+                        if( k < s.size() and s[k] == '0' ){ f.zero = not f.align; k++; }
+                        while( k < s.size() and s[k] >= '0' and s[k] <= '9' ) f.width = f.width*10 + s[k++] - '0';
+                        if( k < s.size() ) f.type = s[k];
+                        }
+                    if( ai < args.size() ){ out += field( args[ai], f, elf, sAddr[ai] ); ai++; }
+                    }
+                return true;
+                }
+
+//........................................................................................
+
+                int
+main            (int argc, char** argv)
+                {
+                if( argc < 3 ){
+                    fprintf( stderr, "usage: %s <elf> <tty|file|->\n", argv[0] );
+                    return 2;
+                    }
+                Elf elf;
+                if( not elf.load(argv[1]) ){ fprintf( stderr, "%s: not an elf32 file with a .logstr section\n", argv[1] ); return 2; }
+                int fd = strcmp(argv[2], "-") ? open( argv[2], O_RDONLY bitor O_NOCTTY ) : 0;
+                if( fd < 0 ){ perror( argv[2] ); return 2; }
+                if( isatty(fd) ){ //board uart is 1MBaud
+                    termios t;
+                    tcgetattr( fd, &t );
+                    cfmakeraw( &t );
+                    cfsetspeed( &t, B1000000 );
+                    tcsetattr( fd, TCSANOW, &t );
+                    }
+
+                //A5 len idlo idhi args... sum
+                std::vector<u8> q; //unprocessed bytes
+                u8 buf[256];
+                for( ssize_t n; (n = read(fd, buf, sizeof buf)) > 0; ){
+                    q.insert( q.end(), buf, buf+n );
+                    std::string out;
+                    size_t i = 0;
+                    while( i < q.size() ){
+                        if( q[i] != 0xA5 ){ out += char(q[i++]); continue; }
+                        if( i+2 > q.size() ) break;             //need len
+                        u32 len = q[i+1];
+                        if( len < 2 ){ out += char(q[i++]); continue; }
+                        if( i+3+len > q.size() ) break;         //need whole record
+                        u8 sum = 0;
+                        for( u32 k = 0; k < len; k++ ) sum += q[i+2+k];
+                        if( sum != q[i+2+len] or not decode(elf, &q[i+2], len, out) ){ out += char(q[i++]); continue; }
+                        i += 3 + len;
+                        }
+                    q.erase( q.begin(), q.begin()+i );
+                    fwrite( out.data(), 1, out.size(), stdout );
+                    fflush( stdout );
+                    }
+                //anything left was not a record
+                fwrite( q.data(), 1, q.size(), stdout );
+                return 0;
+                }
@@ -0,0 +1,116 @@
+//........................................................................................
+
+                // host decoder for Telemetry frames (include/Telemetry.hpp)
+
+                // build-   make tools
+                // run-     bin/teldecode /dev/ttyACM0      (uart, 1MBaud)
+                //          bin/teldecode capture.bin       (a saved capture)
+                //          bin/teldecode -                 (stdin)
+
+                // one line per frame-  type #seq fields...
+                //  time_point fields as days/h:m:s.us, durations with a us suffix
+                // missing sequence numbers are shown as <n lost>, anything in the stream
+                // that is not a frame (normal text output, or a frame that fails the
+                // cobs/crc check) is passed through as-is
+
+//........................................................................................
+
+#include "Telemetry.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+//........................................................................................
+
+                //same as the FMT time_point operator<<  "   1d00:01:07.825696"
+                static std::string
+timePoint       (i64 us)
+                {
+                u64 u = us < 0 ? 0 : us;
+                char b[48];
+                snprintf( b, sizeof b, "%4llud%02llu:%02llu:%02llu.%06llu",
+                          (unsigned long long)(u/86400000000ULL), (unsigned long long)(u/3600000000ULL%24),
+                          (unsigned long long)(u/60000000ULL%60), (unsigned long long)(u/1000000ULL%60), (unsigned long long)(u%1000000ULL) );
+                return b;
+                }
+
+                struct Stats { u32 frames, lost; int lastSeq = -1; };
+
+                //a chunk between 0 bytes- a frame -> text line, or the chunk as-is
+                static std::string
+chunk           (const u8* p, u32 n, Stats& st)
+                {
+                std::vector<u8> raw( n );
+                u32 len;
+                if( not Telemetry::decode(p, n, raw.data(), len) ){
+                    return std::string( reinterpret_cast<const char*>(p), n );
+                    }
+                st.frames++;
+                std::string out;
+                int seq = raw[1];
+                if( st.lastSeq >= 0 and seq != ((st.lastSeq + 1) bitand 0xFF) ){
+                    auto lost = (seq - st.lastSeq - 1) bitand 0xFF;
+                    st.lost += lost;
+                    out += "<" + std::to_string(lost) + " lost>\n";
+                    }
+                st.lastSeq = seq;
+                char b[64];
+                snprintf( b, sizeof b, "%3u #%03d", raw[0], seq );
+                out += b;
+                u32 i = 2;
+                char code;
+                i64 v;
+                while( Telemetry::field(raw.data(), len, i, code, v) ){
+                    out += ' ';
+                    switch( code ){
+                        case 'T': out += timePoint( v ); break;
+                        case 'D': out += std::to_string( v ) + "us"; break;
+                        case 'u': out += std::to_string( static_cast<u64>(v) ); break;
+                        default:  out += std::to_string( v ); break;
+                        }
+                    }
+                if( i != len ) out += " <bad field>";
+                return out + '\n';
+                }
+
+//........................................................................................
+
+                int
+main            (int argc, char** argv)
+                {
+                if( argc < 2 ){
+                    fprintf( stderr, "usage: %s <tty|file|->\n", argv[0] );
+                    return 2;
+                    }
+                int fd = strcmp(argv[1], "-") ? open( argv[1], O_RDONLY bitor O_NOCTTY ) : 0;
+                if( fd < 0 ){ perror( argv[1] ); return 2; }
+                if( isatty(fd) ){ //board uart is 1MBaud
+                    termios t;
+                    tcgetattr( fd, &t );
+                    cfmakeraw( &t );
+                    cfsetspeed( &t, B1000000 );
+                    tcsetattr( fd, TCSANOW, &t );
+                    }
+
+                Stats st{};
+                std::vector<u8> q; //bytes after the last 0
+                u8 buf[256];
+                for( ssize_t n; (n = read(fd, buf, sizeof buf)) > 0; ){
+                    std::string out;
+                    for( ssize_t k = 0; k < n; k++ ){
+                        if( buf[k] ){ q.push_back( buf[k] ); continue; }
+                        if( q.size() ) out += chunk( q.data(), q.size(), st );
+                        q.clear();
+                        }
+                    fwrite( out.data(), 1, out.size(), stdout );
+                    fflush( stdout );
+                    }
+                //anything left was not a frame
+                fwrite( q.data(), 1, q.size(), stdout );
+                fprintf( stderr, "\nframes: %u  lost: %u\n", st.frames, st.lost );
+                return 0;
+                }